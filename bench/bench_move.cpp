@@ -0,0 +1,124 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+// Counts heap allocations in a parse-and-transform workload: records are
+// parsed, checked by type and rewrapped into a new document, once by
+// copying subtrees and once by moving them with the ownership API.
+
+#include "jsonn.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+std::string make_records(size_t count) {
+    std::string out = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) out += ",";
+        out += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i) +
+               "\",\"tags\":[\"alpha\",\"beta\",\"gamma\"],\"address\":{\"country\":\"PL\",\"city\":\"Warsaw\"," +
+               "\"street\":\"Marszalkowska " + std::to_string(i) + "\"}}";
+    }
+    return out + "]";
+}
+
+// What the old API forced: try_get_* returned copies and constructors took
+// const references, so every step copies the subtree
+jsonn::Value transform_copy(const jsonn::Value& doc) {
+    jsonn::Array out;
+    for (const jsonn::Value& rec : doc.as_array()) {
+        jsonn::Object record = rec.as_object();
+        jsonn::Object wrapped;
+        wrapped["address"] = jsonn::Value(record.at("address").as_object());
+        wrapped["tags"] = jsonn::Value(record.at("tags").as_array());
+        record.erase("address");
+        record.erase("tags");
+        wrapped["record"] = jsonn::Value(record);
+        out.push_back(jsonn::Value(wrapped));
+    }
+    return jsonn::Value(out);
+}
+
+jsonn::Value transform_move(jsonn::Value& doc) {
+    jsonn::Array out;
+    jsonn::Array* records = doc.try_get_array();
+    out.reserve(records->size());
+    for (jsonn::Value& rec : *records) {
+        jsonn::Object* record = rec.try_get_object();
+        jsonn::Object wrapped;
+        wrapped.insert_or_assign("address", *record->extract("address"));
+        wrapped.insert_or_assign("tags", *record->extract("tags"));
+        wrapped.insert_or_assign("record", rec.release());
+        out.push_back(std::move(wrapped));
+    }
+    return out;
+}
+
+template <class F>
+void measure(const char* name, const std::string& text, F&& transform) {
+    jsonn::Value doc = jsonn::parse(text);
+    size_t before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    jsonn::Value result = transform(doc);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    size_t count = allocations.load() - before;
+    std::printf("%-5s %zu records: %9zu allocations, %7.1f ms, %zu bytes out\n",
+                name, result.as_array().size(), count, elapsed.count(), jsonn::serialize(result).size());
+}
+
+} // namespace
+
+int main() {
+    const std::string text = make_records(100000);
+    measure("copy", text, [](jsonn::Value& doc) { return transform_copy(doc); });
+    measure("move", text, [](jsonn::Value& doc) { return transform_move(doc); });
+    return 0;
+}
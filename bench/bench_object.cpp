@@ -0,0 +1,156 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Compares the flat jsonn::Object with the std::map<std::string, Value> it
+// replaced, for building (what the parser does per member), key lookup and
+// serialization, plus end-to-end parse/serialize of an object-heavy document.
+
+#include "jsonn.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using MapObject = std::map<std::string, jsonn::Value>;
+
+volatile size_t sink;
+
+template <class F>
+double ns_per_op(size_t ops, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ops;
+}
+
+std::vector<std::string> make_keys(size_t n) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i) keys.push_back("field_" + std::to_string(i * 7919 % 1000));
+    return keys;
+}
+
+template <class Obj>
+Obj build(const std::vector<std::string>& keys) {
+    Obj o;
+    for (size_t i = 0; i < keys.size(); ++i) o[keys[i]] = static_cast<int>(i);
+    return o;
+}
+
+template <class Obj>
+void write_object(std::string& out, const Obj& o) {
+    out.push_back('{');
+    bool first = true;
+    for (const auto& [key, val] : o) {
+        if (!first) out.push_back(',');
+        first = false;
+        out.push_back('"');
+        out.append(key);
+        out.append("\":", 2);
+        jsonn::serialize_to(out, val);
+    }
+    out.push_back('}');
+}
+
+template <class Obj>
+void compare(const char* name, size_t key_count) {
+    const std::vector<std::string> keys = make_keys(key_count);
+    const size_t rounds = 2000000 / key_count;
+
+    double build_ns = ns_per_op(rounds * key_count, [&] {
+        for (size_t r = 0; r < rounds; ++r) sink = build<Obj>(keys).size();
+    });
+
+    Obj o = build<Obj>(keys);
+    std::mt19937 rng(7);
+    std::vector<size_t> order(rounds * key_count);
+    for (auto& i : order) i = rng() % key_count;
+    double lookup_ns = ns_per_op(order.size(), [&] {
+        size_t hits = 0;
+        for (size_t i : order) hits += o.find(keys[i]) != o.end();
+        sink = hits;
+    });
+
+    std::string out;
+    double serialize_ns = ns_per_op(rounds * key_count, [&] {
+        for (size_t r = 0; r < rounds; ++r) {
+            out.clear();
+            write_object(out, o);
+        }
+        sink = out.size();
+    });
+
+    std::printf("%-6s %4zu keys: build %6.1f ns/key, lookup %6.1f ns, serialize %6.1f ns/key\n",
+                name, key_count, build_ns, lookup_ns, serialize_ns);
+}
+
+std::string make_records(size_t count) {
+    std::string out = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) out += ",";
+        out += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i) +
+               "\",\"active\":true,\"score\":" + std::to_string(i % 100) +
+               ",\"country\":\"PL\",\"city\":\"Warsaw\",\"age\":" + std::to_string(20 + i % 50) +
+               ",\"email\":\"user" + std::to_string(i) + "@example.com\"}";
+    }
+    return out + "]";
+}
+
+} // namespace
+
+int main() {
+    for (size_t n : {4, 12, 64}) {
+        compare<MapObject>("map", n);
+        compare<jsonn::Object>("flat", n);
+    }
+
+    const std::string doc = make_records(100000);
+    const int iterations = 5;
+    jsonn::Value v;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) v = jsonn::parse(doc);
+    std::chrono::duration<double> parse_s = std::chrono::steady_clock::now() - start;
+
+    std::string out;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        out.clear();
+        jsonn::serialize_to(out, v);
+    }
+    std::chrono::duration<double> serialize_s = std::chrono::steady_clock::now() - start;
+
+    double mb = doc.size() * iterations / (1024.0 * 1024.0);
+    std::printf("records: parse %.1f MB/s, serialize %.1f MB/s\n", mb / parse_s.count(), mb / serialize_s.count());
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Compares the scalar parser with the two-stage indexed parser, and the
+// Value tree with the arena-backed Document and the on-demand LazyDocument,
+// on a generated telemetry-like payload.
+
+#include "jsonn.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+std::string make_telemetry(size_t target_size) {
+    std::mt19937 rng(42);
+    std::string out = "[";
+    for (size_t i = 0; out.size() < target_size; ++i) {
+        if (i) out += ",\n  ";
+        out += "{\"id\": " + std::to_string(rng() % 1000000) +
+               ", \"host\": \"node-" + std::to_string(rng() % 512) + ".example.internal\"" +
+               ", \"ok\": " + (rng() % 2 ? "true" : "false") +
+               ", \"latency_ms\": " + std::to_string((rng() % 100000) / 100.0) +
+               ", \"tags\": [\"edge\", \"tier-" + std::to_string(rng() % 4) + "\", null]" +
+               ", \"msg\": \"request served with \\\"status\\\" " + std::to_string(200 + rng() % 300) + "\"}";
+    }
+    out += "]";
+    return out;
+}
+
+double run(const std::string& doc, const jsonn::ParseOptions& options, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        jsonn::Value v = jsonn::parse(doc, options);
+        if (!v.is_array()) std::abort();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return doc.size() * iterations / elapsed.count() / (1024.0 * 1024.0);
+}
+
+double run_document(const std::string& doc, const jsonn::ParseOptions& options, int iterations) {
+    jsonn::Document document;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        jsonn::Element root = document.parse(doc, options);
+        if (!root.is_array()) std::abort();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return doc.size() * iterations / elapsed.count() / (1024.0 * 1024.0);
+}
+
+// Reads two fields of every record, the rest is only stepped over
+double run_lazy(const std::string& doc, int iterations) {
+    jsonn::LazyDocument document;
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        jsonn::LazyValue root = document.parse(doc);
+        for (jsonn::LazyValue record : root.as_array()) {
+            sum += record["id"].as_number();
+            sum += record["host"].as_string().size();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (sum < 0) std::abort();
+    return doc.size() * iterations / elapsed.count() / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main() {
+    const std::string doc = make_telemetry(8 << 20);
+    const int iterations = 10;
+
+    jsonn::ParseOptions scalar;
+    jsonn::ParseOptions indexed;
+    indexed.mode = jsonn::ParseMode::indexed;
+
+    std::printf("document: %.1f MB, stage 1 kernel: %s\n", doc.size() / (1024.0 * 1024.0), jsonn::simd_kernel());
+    std::printf("%-18s %8.1f MB/s\n", "value scalar", run(doc, scalar, iterations));
+    std::printf("%-18s %8.1f MB/s\n", "value indexed", run(doc, indexed, iterations));
+    std::printf("%-18s %8.1f MB/s\n", "document scalar", run_document(doc, scalar, iterations));
+    std::printf("%-18s %8.1f MB/s\n", "document indexed", run_document(doc, indexed, iterations));
+    std::printf("%-18s %8.1f MB/s\n", "lazy, 2 fields", run_lazy(doc, iterations));
+    return 0;
+}
@@ -0,0 +1,401 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+// Benchmark suite over a generated corpus: twitter-like, canada-like
+// (numeric heavy), deeply nested, string heavy, and a large JSONL file. For
+// each API it reports MB/s, documents/s, allocations per document and peak
+// RSS, and sweeps thread counts for the JSONL paths. Every case runs in a
+// forked child so its peak RSS and allocations are its own.
+//
+//     bench_suite [--json out.json] [--compare old.json] [--scale 0.5] [--filter jsonl]
+
+#include "jsonn.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef JSONN_VERSION
+#define JSONN_VERSION "unknown"
+#endif
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Corpus, the same bytes on every run for a given scale
+
+std::string make_twitter(size_t target, std::mt19937& rng) {
+    static const char* words[] = {"json", "parser", "fast", "zażółć", "release", "東京", "benchmark", "🚀", "cache", "simd"};
+    std::string out = "{\"statuses\":[";
+    for (size_t i = 0; out.size() < target; ++i) {
+        if (i) out += ",";
+        std::string text;
+        for (int w = 0; w < 12; ++w) text += std::string(words[rng() % 10]) + " ";
+        out += "{\"created_at\":\"Sun Aug 31 00:29:15 +0000 2025\",\"id\":" + std::to_string(505874924095815681ULL + i) +
+               ",\"text\":\"" + text + "\\n#jsonn\",\"truncated\":false,\"user\":{\"id\":" + std::to_string(rng()) +
+               ",\"name\":\"user " + std::to_string(i) + "\",\"screen_name\":\"u" + std::to_string(rng() % 100000) +
+               "\",\"followers_count\":" + std::to_string(rng() % 50000) + ",\"verified\":" + (rng() % 2 ? "true" : "false") +
+               ",\"url\":null},\"entities\":{\"hashtags\":[{\"text\":\"jsonn\",\"indices\":[0,6]}],\"urls\":[]}," +
+               "\"retweet_count\":" + std::to_string(rng() % 1000) + ",\"favorited\":false,\"lang\":\"en\"}";
+    }
+    return out + "],\"search_metadata\":{\"count\":100}}";
+}
+
+std::string make_canada(size_t target, std::mt19937& rng) {
+    std::uniform_real_distribution<double> lon(-141.0, -52.0), lat(41.0, 83.0);
+    std::string out = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+                      "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+    char buf[64];
+    for (size_t ring = 0; out.size() < target; ++ring) {
+        if (ring) out += ",";
+        out += "[";
+        for (int p = 0; p < 512; ++p) {
+            std::snprintf(buf, sizeof(buf), "%s[%.15g,%.15g]", p ? "," : "", lon(rng), lat(rng));
+            out += buf;
+        }
+        out += "]";
+    }
+    return out + "]}}]}";
+}
+
+// Chains of objects and arrays 256 levels deep
+std::string make_nested(size_t target, std::mt19937& rng) {
+    std::string out = "[";
+    for (size_t i = 0; out.size() < target; ++i) {
+        if (i) out += ",";
+        int depth = 256;
+        for (int d = 0; d < depth; ++d) out += d % 2 ? "[" : "{\"k\":";
+        out += std::to_string(rng() % 1000);
+        for (int d = depth; d-- > 0;) out += d % 2 ? "]" : "}";
+    }
+    return out + "]";
+}
+
+std::string make_strings(size_t target, std::mt19937& rng) {
+    static const char* pieces[] = {"plain ascii text ", "escaped \\\"quotes\\\" ", "tabs\\tand\\nnewlines ",
+                                   "unicode \\u00e9\\u4e2d ", "pairs \\ud83d\\ude00 ", "raw UTF-8 łódź 東京 "};
+    std::string out = "[";
+    for (size_t i = 0; out.size() < target; ++i) {
+        if (i) out += ",";
+        out += "\"";
+        size_t len = 200 + rng() % 4000;
+        for (size_t n = 0; n < len;) {
+            const char* p = pieces[rng() % 6];
+            out += p;
+            n += std::strlen(p);
+        }
+        out += "\"";
+    }
+    return out + "]";
+}
+
+std::string make_jsonl(size_t target, std::mt19937& rng) {
+    std::string out;
+    for (size_t i = 0; out.size() < target; ++i) {
+        out += "{\"id\":" + std::to_string(i) + ",\"ts\":" + std::to_string(1700000000000ULL + rng() % 1000000) +
+               ",\"user\":\"user" + std::to_string(rng() % 100000) + "\",\"event\":\"" + (rng() % 3 ? "click" : "view") +
+               "\",\"score\":" + std::to_string((rng() % 10000) / 100.0) + ",\"tags\":[\"a\",\"b\"],\"meta\":{\"ok\":true,\"ref\":null}}\n";
+    }
+    return out;
+}
+
+// Measurement
+
+struct Result {
+    char corpus[24];
+    char api[32];
+    size_t threads;
+    double mb_per_s;
+    double docs_per_s;
+    double allocs_per_doc;
+    long peak_rss_kb;
+};
+
+struct Case {
+    const char* corpus;
+    const char* api;
+    size_t threads;
+    size_t bytes;        // input or output bytes per iteration
+    size_t docs;         // documents per iteration
+    std::function<std::function<void()>()> setup; // runs in the child, returns one iteration
+};
+
+Result measure(const Case& c) {
+    int fds[2];
+    if (pipe(fds) != 0) std::abort();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::function<void()> iteration = c.setup();
+        iteration(); // warm up caches and pools
+        size_t before = allocations.load();
+        size_t iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed{};
+        while (iterations < 3 || elapsed.count() < 1.0) {
+            iteration();
+            ++iterations;
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        size_t allocs = allocations.load() - before;
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        Result r{};
+        std::snprintf(r.corpus, sizeof(r.corpus), "%s", c.corpus);
+        std::snprintf(r.api, sizeof(r.api), "%s", c.api);
+        r.threads = c.threads;
+        r.mb_per_s = c.bytes * iterations / elapsed.count() / (1024.0 * 1024.0);
+        r.docs_per_s = c.docs * iterations / elapsed.count();
+        r.allocs_per_doc = static_cast<double>(allocs) / (c.docs * iterations);
+        r.peak_rss_kb = usage.ru_maxrss;
+        if (write(fds[1], &r, sizeof(r)) != sizeof(r)) _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    Result r{};
+    bool ok = read(fds[0], &r, sizeof(r)) == sizeof(r);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::fprintf(stderr, "%s/%s failed\n", c.corpus, c.api);
+        std::exit(1);
+    }
+    return r;
+}
+
+void add_document_cases(std::vector<Case>& cases, const char* corpus, const std::string& text) {
+    jsonn::ParseOptions indexed;
+    indexed.mode = jsonn::ParseMode::indexed;
+    const std::string* t = &text;
+
+    cases.push_back({corpus, "parse", 1, text.size(), 1, [t] {
+        return std::function<void()>([t] { if (jsonn::parse(*t).is_null()) std::abort(); });
+    }});
+    cases.push_back({corpus, "parse_indexed", 1, text.size(), 1, [t, indexed] {
+        return std::function<void()>([t, indexed] { if (jsonn::parse(*t, indexed).is_null()) std::abort(); });
+    }});
+    cases.push_back({corpus, "document", 1, text.size(), 1, [t] {
+        auto doc = std::make_shared<jsonn::Document>();
+        return std::function<void()>([t, doc] { if (doc->parse(*t).is_null()) std::abort(); });
+    }});
+    cases.push_back({corpus, "serialize", 1, jsonn::serialize(jsonn::parse(text)).size(), 1, [t] {
+        auto v = std::make_shared<jsonn::Value>(jsonn::parse(*t));
+        auto out = std::make_shared<std::string>();
+        return std::function<void()>([v, out] {
+            out->clear();
+            jsonn::serialize_to(*out, *v);
+        });
+    }});
+}
+
+// 1, 2, 4, ... up to the hardware threads
+std::vector<size_t> thread_sweep() {
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> sweep;
+    for (size_t n = 1; n < max_threads; n *= 2) sweep.push_back(n);
+    sweep.push_back(max_threads);
+    return sweep;
+}
+
+void add_parallel_cases(std::vector<Case>& cases, const char* corpus, const std::string& text) {
+    const std::string* t = &text;
+    for (size_t n : thread_sweep()) {
+        cases.push_back({corpus, "parse_parallel", n, text.size(), 1, [t, n] {
+            auto pool = std::make_shared<jsonn::ThreadPool>(n);
+            return std::function<void()>([t, pool] {
+                jsonn::ParallelOptions options;
+                options.pool = pool.get();
+                if (jsonn::parse_parallel(*t, options).is_null()) std::abort();
+            });
+        }});
+    }
+}
+
+void add_jsonl_cases(std::vector<Case>& cases, const std::string& text, size_t records) {
+    const std::string* t = &text;
+    std::vector<size_t> sweep = thread_sweep();
+
+    for (size_t n : sweep) {
+        cases.push_back({"jsonl", "parse_jsonl", n, text.size(), records, [t, n] {
+            auto pool = std::make_shared<jsonn::ThreadPool>(n);
+            return std::function<void()>([t, pool] {
+                jsonn::ParallelOptions options;
+                options.pool = pool.get();
+                if (jsonn::parse_jsonl(*t, options).empty()) std::abort();
+            });
+        }});
+    }
+    for (size_t n : sweep) {
+        cases.push_back({"jsonl", "serialize_jsonl", n, text.size(), records, [t, n] {
+            auto pool = std::make_shared<jsonn::ThreadPool>(n);
+            auto values = std::make_shared<std::vector<jsonn::Value>>(jsonn::parse_jsonl(*t));
+            return std::function<void()>([pool, values] {
+                jsonn::ParallelOptions options;
+                options.pool = pool.get();
+                if (jsonn::serialize_jsonl(*values, options).empty()) std::abort();
+            });
+        }});
+    }
+}
+
+jsonn::Value to_json(const std::vector<Result>& results, double scale) {
+    jsonn::Value out;
+    out.insert("library_version", JSONN_VERSION);
+    out.insert("kernel", jsonn::simd_kernel());
+    out.insert("hardware_threads", std::thread::hardware_concurrency());
+    out.insert("scale", scale);
+    jsonn::Array rows;
+    for (const Result& r : results) {
+        jsonn::Value row;
+        row.insert("corpus", r.corpus);
+        row.insert("api", r.api);
+        row.insert("threads", r.threads);
+        row.insert("mb_per_s", r.mb_per_s);
+        row.insert("docs_per_s", r.docs_per_s);
+        row.insert("allocs_per_doc", r.allocs_per_doc);
+        row.insert("peak_rss_kb", r.peak_rss_kb);
+        rows.push_back(std::move(row));
+    }
+    out.insert("results", std::move(rows));
+    return out;
+}
+
+// Percent change in MB/s against a results file from an earlier run
+void compare(const std::vector<Result>& results, const std::string& path) {
+    std::ifstream f(path);
+    if (!f) {
+        std::fprintf(stderr, "cannot read %s\n", path.c_str());
+        return;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    jsonn::Value old = jsonn::parse(ss.str());
+    std::printf("\nchange against %s (MB/s)\n", path.c_str());
+    for (const Result& r : results) {
+        for (const jsonn::Value& row : old["results"].as_array()) {
+            if (row["corpus"].as_string() == r.corpus && row["api"].as_string() == r.api &&
+                row["threads"].as_uint() == r.threads) {
+                double before = row["mb_per_s"].as_number();
+                std::printf("%-8s %-16s %3zu  %+7.1f%%\n", r.corpus, r.api, r.threads, (r.mb_per_s / before - 1) * 100);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string json_path, compare_path, filter;
+    double scale = 1.0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--json") json_path = argv[i + 1];
+        else if (arg == "--compare") compare_path = argv[i + 1];
+        else if (arg == "--scale") scale = std::atof(argv[i + 1]);
+        else if (arg == "--filter") filter = argv[i + 1];
+        else {
+            std::fprintf(stderr, "usage: %s [--json out.json] [--compare old.json] [--scale f] [--filter text]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(2025);
+    auto size = [&](double mb) { return static_cast<size_t>(mb * scale * 1024 * 1024); };
+    const std::string twitter = make_twitter(size(4), rng);
+    const std::string canada = make_canada(size(4), rng);
+    const std::string nested = make_nested(size(2), rng);
+    const std::string strings = make_strings(size(4), rng);
+    const std::string jsonl = make_jsonl(size(64), rng);
+    size_t records = std::count(jsonl.begin(), jsonl.end(), '\n');
+
+    std::vector<Case> cases;
+    add_document_cases(cases, "twitter", twitter);
+    add_document_cases(cases, "canada", canada);
+    add_parallel_cases(cases, "twitter", twitter);
+    add_parallel_cases(cases, "canada", canada);
+    add_document_cases(cases, "nested", nested);
+    add_document_cases(cases, "strings", strings);
+    add_jsonl_cases(cases, jsonl, records);
+
+    std::printf("stage 1 kernel: %s, %u hardware threads\n", jsonn::simd_kernel(), std::thread::hardware_concurrency());
+    std::printf("%-8s %-16s %7s %10s %12s %12s %12s\n", "corpus", "api", "threads", "MB/s", "docs/s", "allocs/doc", "peak RSS kB");
+    std::vector<Result> results;
+    for (const Case& c : cases) {
+        std::string name = std::string(c.corpus) + "/" + c.api;
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+        Result r = measure(c);
+        std::printf("%-8s %-16s %7zu %10.1f %12.1f %12.1f %12ld\n",
+                    r.corpus, r.api, r.threads, r.mb_per_s, r.docs_per_s, r.allocs_per_doc, r.peak_rss_kb);
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        out << jsonn::serialize(to_json(results, scale)) << "\n";
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", json_path.c_str());
+            return 1;
+        }
+    }
+    if (!compare_path.empty()) compare(results, compare_path);
+    return 0;
+}
@@ -32,19 +32,134 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
-#include <map>
+#include <memory>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
 #include <stdexcept>
 #include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 
 namespace jsonn {
 
 struct Value;
+class KeyTable;
+class Reader;
+namespace detail { struct ValueBuilder; struct Number; }
+
+// Object storage: keys and values live in two contiguous vectors, in
+// insertion order. Objects with fewer than hash_threshold keys are searched
+// linearly, larger ones keep a hash index next to the keys. The key list is
+// shared copy-on-write between copies, so objects with the same keys can
+// reuse one key table.
+class __attribute__((visibility("default"))) Object {
+public:
+    static constexpr size_t hash_threshold = 16;
+
+    template <bool Const>
+    class basic_iterator {
+        using value_ptr = std::conditional_t<Const, const Value*, Value*>;
+        using value_ref = std::conditional_t<Const, const Value&, Value&>;
+
+    public:
+        using reference = std::pair<const std::string&, value_ref>;
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        basic_iterator(const std::string* k, value_ptr v) : key(k), val(v) {}
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) : key(other.key), val(other.val) {}
+
+        reference operator*() const { return {*key, *val}; }
+        pointer operator->() const { return {**this}; }
+        basic_iterator& operator++() { ++key; ++val; return *this; }
+        basic_iterator operator++(int) { basic_iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const basic_iterator& other) const { return val == other.val; }
+        bool operator!=(const basic_iterator& other) const { return val != other.val; }
+
+    private:
+        friend class Object;
+        template <bool> friend class basic_iterator;
+        const std::string* key;
+        value_ptr val;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    Object() = default;
+    Object(std::initializer_list<std::pair<const std::string, Value>> init);
+
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t n);
+    void clear();
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Lookup
+    iterator find(std::string_view key);
+    const_iterator find(std::string_view key) const;
+    size_t count(std::string_view key) const { return index_of(key) >= 0 ? 1 : 0; }
+    bool contains(std::string_view key) const { return index_of(key) >= 0; }
+    Value& at(std::string_view key);
+    const Value& at(std::string_view key) const;
+
+    // Insertion keeps the order keys were first added in
+    Value& operator[](std::string_view key);
+    std::pair<iterator, bool> emplace(std::string_view key, Value v);
+    std::pair<iterator, bool> insert(const std::pair<const std::string, Value>& kv);
+    std::pair<iterator, bool> insert(std::pair<std::string, Value>&& kv);
+    Value& insert_or_assign(std::string key, Value v);
+    size_t erase(std::string_view key);
+    // Removes the member and hands its value over, nullopt if missing
+    std::optional<Value> extract(std::string_view key);
+
+    bool operator==(const Object& other) const;
+    bool operator!=(const Object& other) const { return !(*this == other); }
+
+private:
+    friend class KeyTable;
+    friend struct detail::ValueBuilder;
+
+    struct Keys {
+        std::vector<std::string> names;
+        std::vector<uint32_t> slots; // hash index: position + 1, 0 when empty
+    };
+
+    ptrdiff_t index_of(std::string_view key) const {
+        if (!keys) return -1;
+        if (!keys->slots.empty()) return hashed_index_of(key);
+        const std::vector<std::string>& names = keys->names;
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == key) return static_cast<ptrdiff_t>(i);
+        }
+        return -1;
+    }
+
+    ptrdiff_t hashed_index_of(std::string_view key) const;
+    Keys& own_keys();
+    void index_last();
+    void rebuild_index();
+
+    std::shared_ptr<Keys> keys;
+    std::vector<Value> values;
+};
 
-using Object = std::map<std::string, Value>;
 using Array = std::vector<Value>;
-using ValueType = std::variant<std::nullptr_t, bool, int, double, std::string, Array, Object>;
+// Integers are int64_t; uint64_t only holds values above INT64_MAX, so
+// every integer has one representation
+using ValueType = std::variant<std::nullptr_t, bool, int64_t, uint64_t, double, std::string, Array, Object>;
 
 struct Value {
     ValueType data;
@@ -53,18 +168,34 @@ struct Value {
     Value() : data(nullptr) {}
     Value(std::nullptr_t) : data(nullptr) {}
     Value(bool b) : data(b) {}
-    Value(int i) : data(i) {}
+    template <class T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Value(T i) {
+        if constexpr (std::is_signed_v<T>) {
+            data = static_cast<int64_t>(i);
+        } else if (static_cast<uint64_t>(i) <= static_cast<uint64_t>(INT64_MAX)) {
+            data = static_cast<int64_t>(i);
+        } else {
+            data = static_cast<uint64_t>(i);
+        }
+    }
     Value(double d) : data(d) {}
     Value(const std::string& s) : data(s) {}
-    Value(const char* s) : data(std::string(s)) {}
+    Value(std::string&& s) : data(std::move(s)) {}
+    Value(std::string_view s) : data(std::in_place_type<std::string>, s) {}
+    Value(const char* s) : data(std::in_place_type<std::string>, s) {}
+    // Arrays and objects passed as rvalues are moved in, not copied
     Value(const Array& a) : data(a) {}
+    Value(Array&& a) : data(std::move(a)) {}
     Value(const Object& o) : data(o) {}
-    
+    Value(Object&& o) : data(std::move(o)) {}
+
     // Type checks
     bool is_object() const { return std::holds_alternative<Object>(data); }
     bool is_array()  const { return std::holds_alternative<Array>(data); }
     bool is_string() const { return std::holds_alternative<std::string>(data); }
-    bool is_number() const { return std::holds_alternative<int>(data) || std::holds_alternative<double>(data); }    bool is_bool()   const { return std::holds_alternative<bool>(data); }
+    bool is_number() const { return is_int() || std::holds_alternative<double>(data); }
+    bool is_int()    const { return std::holds_alternative<int64_t>(data) || std::holds_alternative<uint64_t>(data); }
+    bool is_bool()   const { return std::holds_alternative<bool>(data); }
     bool is_null()   const { return std::holds_alternative<std::nullptr_t>(data); }
 
     // Getters
@@ -72,19 +203,55 @@ struct Value {
     const Object& as_object() const { return std::get<Object>(data); }
     const std::string& as_string() const { return std::get<std::string>(data); }
     double as_number() const {
-        if (std::holds_alternative<int>(data)) return static_cast<double>(std::get<int>(data));
+        if (auto i = std::get_if<int64_t>(&data)) return static_cast<double>(*i);
+        if (auto u = std::get_if<uint64_t>(&data)) return static_cast<double>(*u);
         return std::get<double>(data);
     }
+    // Exact integer getters, throw std::out_of_range when the value doesn't fit
+    int64_t as_int() const {
+        if (std::holds_alternative<uint64_t>(data)) throw std::out_of_range("Integer out of range");
+        return std::get<int64_t>(data);
+    }
+    uint64_t as_uint() const {
+        if (auto u = std::get_if<uint64_t>(&data)) return *u;
+        int64_t i = std::get<int64_t>(data);
+        if (i < 0) throw std::out_of_range("Integer out of range");
+        return static_cast<uint64_t>(i);
+    }
     bool as_bool() const { return std::get<bool>(data); }
 
     // Safe getters
     std::optional<double> try_get_number() const { return is_number() ? std::make_optional(as_number()) : std::nullopt; }
-    std::optional<std::string> try_get_string() const { return is_string() ? std::make_optional(as_string()) : std::nullopt; }
+    std::optional<int64_t> try_get_int() const { return std::holds_alternative<int64_t>(data) ? std::make_optional(std::get<int64_t>(data)) : std::nullopt; }
     std::optional<bool> try_get_bool() const { return is_bool() ? std::make_optional(as_bool()) : std::nullopt; }
-    std::optional<Array> try_get_array() const { return is_array() ? std::make_optional(as_array()) : std::nullopt; }
-    std::optional<Object> try_get_object() const { return is_object() ? std::make_optional(as_object()) : std::nullopt; }
-    
-        // Operators for objects
+    // Strings, arrays and objects come back as pointers into the Value,
+    // nullptr when the type differs
+    const std::string* try_get_string() const { return std::get_if<std::string>(&data); }
+    std::string* try_get_string() { return std::get_if<std::string>(&data); }
+    const Array* try_get_array() const { return std::get_if<Array>(&data); }
+    Array* try_get_array() { return std::get_if<Array>(&data); }
+    const Object* try_get_object() const { return std::get_if<Object>(&data); }
+    Object* try_get_object() { return std::get_if<Object>(&data); }
+
+    // Ownership transfer
+    // Moves the value out, leaving null behind
+    Value release() {
+        Value v = std::move(*this);
+        data = nullptr;
+        return v;
+    }
+    // Appends to an array, turning a non-array into an empty one first
+    void push_back(Value v) {
+        if (!is_array()) data = Array{};
+        std::get<Array>(data).push_back(std::move(v));
+    }
+    // Sets a member of an object, turning a non-object into an empty one first
+    Value& insert(std::string key, Value v) {
+        if (!is_object()) data = Object{};
+        return std::get<Object>(data).insert_or_assign(std::move(key), std::move(v));
+    }
+
+    // Operators for objects
     Value& operator[](const std::string& key) {
         if (!is_object()) {
             data = Object{};
@@ -122,10 +289,999 @@ struct Value {
     }
 };
 
+// Object members that need Value to be complete
+
+inline size_t Object::size() const { return values.size(); }
+inline bool Object::empty() const { return values.empty(); }
+
+inline Object::iterator Object::begin() {
+    return iterator(keys ? keys->names.data() : nullptr, values.data());
+}
+inline Object::iterator Object::end() {
+    return iterator(keys ? keys->names.data() + keys->names.size() : nullptr, values.data() + values.size());
+}
+inline Object::const_iterator Object::begin() const {
+    return const_iterator(keys ? keys->names.data() : nullptr, values.data());
+}
+inline Object::const_iterator Object::end() const {
+    return const_iterator(keys ? keys->names.data() + keys->names.size() : nullptr, values.data() + values.size());
+}
+
+inline Object::iterator Object::find(std::string_view key) {
+    ptrdiff_t i = index_of(key);
+    return i < 0 ? end() : iterator(keys->names.data() + i, values.data() + i);
+}
+
+inline Object::const_iterator Object::find(std::string_view key) const {
+    ptrdiff_t i = index_of(key);
+    return i < 0 ? end() : const_iterator(keys->names.data() + i, values.data() + i);
+}
+
+inline Value& Object::at(std::string_view key) {
+    ptrdiff_t i = index_of(key);
+    if (i < 0) throw std::out_of_range("Key not found: " + std::string(key));
+    return values[i];
+}
+
+inline const Value& Object::at(std::string_view key) const {
+    ptrdiff_t i = index_of(key);
+    if (i < 0) throw std::out_of_range("Key not found: " + std::string(key));
+    return values[i];
+}
+
+inline std::pair<Object::iterator, bool> Object::emplace(std::string_view key, Value v) {
+    ptrdiff_t i = index_of(key);
+    if (i >= 0) return {iterator(keys->names.data() + i, values.data() + i), false};
+    Keys& k = own_keys();
+    k.names.emplace_back(key);
+    values.push_back(std::move(v));
+    if (k.names.size() >= hash_threshold) index_last();
+    return {iterator(k.names.data() + k.names.size() - 1, values.data() + values.size() - 1), true};
+}
+
+inline std::pair<Object::iterator, bool> Object::insert(const std::pair<const std::string, Value>& kv) {
+    return emplace(kv.first, kv.second);
+}
+
+inline std::pair<Object::iterator, bool> Object::insert(std::pair<std::string, Value>&& kv) {
+    ptrdiff_t i = index_of(kv.first);
+    if (i >= 0) return {iterator(keys->names.data() + i, values.data() + i), false};
+    insert_or_assign(std::move(kv.first), std::move(kv.second));
+    Keys& k = *keys;
+    return {iterator(k.names.data() + k.names.size() - 1, values.data() + values.size() - 1), true};
+}
+
+inline Value& Object::operator[](std::string_view key) {
+    return *emplace(key, Value()).first.val;
+}
+
+inline Value& Object::insert_or_assign(std::string key, Value v) {
+    ptrdiff_t i = index_of(key);
+    if (i >= 0) return values[i] = std::move(v);
+    Keys& k = own_keys();
+    k.names.push_back(std::move(key));
+    values.push_back(std::move(v));
+    if (k.names.size() >= hash_threshold) index_last();
+    return values.back();
+}
+
+struct SerializeOptions {
+    // Spaces per nesting level, 0 writes everything on one line
+    unsigned indent = 0;
+    // Object members in byte order of their keys instead of insertion order
+    bool sort_keys = false;
+    // Escape everything outside ASCII as \uXXXX, surrogate pairs above U+FFFF
+    bool ascii_only = false;
+    // Significant digits for doubles, 0 writes the shortest round-trip form
+    int precision = 0;
+    // RFC 8785 (JCS) output for hashing and signing: compact, keys sorted by
+    // UTF-16 code units, only required escapes, numbers as ECMAScript
+    // writes them. Overrides the other options. Integers beyond 2^53 are
+    // written as the nearest double, NaN and infinity throw.
+    bool canonical = false;
+};
+
+// Appends serialized values into one growable buffer.
+// The buffer keeps its capacity across clear(), so a Writer reused for
+// many documents stops allocating once it has seen the largest one.
+class __attribute__((visibility("default"))) Writer {
+public:
+    Writer() = default;
+    explicit Writer(size_t reserve) { buf.reserve(reserve); }
+
+    void write(const Value& v);
+    void write(const Value& v, const SerializeOptions& options);
+
+    void clear() { buf.clear(); }
+    size_t size() const { return buf.size(); }
+    const std::string& str() const { return buf; }
+    std::string take() { return std::move(buf); }
+
+private:
+    std::string buf;
+};
+
 __attribute__((visibility("default"))) std::string serialize(const Value& v);
-__attribute__((visibility("default"))) Value parse(const std::string& json);
+__attribute__((visibility("default"))) void serialize_to(std::string& out, const Value& v);
+__attribute__((visibility("default"))) std::string serialize(const Value& v, const SerializeOptions& options);
+__attribute__((visibility("default"))) void serialize_to(std::string& out, const Value& v, const SerializeOptions& options);
+
+// Scalar walks the input byte by byte. Indexed first builds an index of all
+// structural positions with SIMD kernels (AVX2 or SSE4.2, picked at runtime,
+// with a scalar fallback) and then builds the Value by walking that index.
+enum class ParseMode { scalar, indexed };
+
+// Interns the key lists of parsed objects. Objects with the same keys in the
+// same order share one key list and hash index instead of each holding
+// copies, which is what JSONL records usually look like, and two objects
+// sharing a list compare keys by pointer. Changing a parsed object copies
+// its key list first. A table isn't thread-safe, use one per thread; parsed
+// values stay valid after it is cleared or destroyed.
+class __attribute__((visibility("default"))) KeyTable {
+public:
+    // Tables stop growing at max_shapes key lists, and objects with more
+    // than max_keys keys are never interned
+    explicit KeyTable(size_t max_shapes = 4096, size_t max_keys = 256);
+    ~KeyTable();
+    KeyTable(const KeyTable&) = delete;
+    KeyTable& operator=(const KeyTable&) = delete;
+
+    // Key lists interned so far, prefixes of longer lists included
+    size_t size() const { return shapes.size() - 1; }
+    void clear();
+
+private:
+    friend struct detail::ValueBuilder;
+    struct Shape;
+
+    Shape* root() { return shapes.front().get(); }
+    // Follows key from shape, storing where its value goes in slot. Returns
+    // nullptr when the table is full.
+    Shape* step(Shape* shape, std::string_view key, uint32_t& slot);
+    // Gives obj the key list of shape, its values must already line up
+    static void attach(Object& obj, Shape* shape);
+
+    size_t max_shapes;
+    size_t max_keys;
+    std::vector<std::unique_ptr<Shape>> shapes;
+};
+
+struct ParseOptions {
+    ParseMode mode = ParseMode::scalar;
+    // Reject strings that aren't well-formed UTF-8. Trusted input can turn
+    // this off to skip the check.
+    bool validate_utf8 = true;
+    // Document only: strings without escapes point into the input instead
+    // of being copied into the arena. The input must then outlive the
+    // Document's Elements.
+    bool borrow_strings = false;
+    // Value parsing only: intern object keys in this table
+    KeyTable* keys = nullptr;
+    // Deepest nesting of arrays and objects accepted. Bounds the recursion
+    // of the parsers, so hostile input can't overflow the stack.
+    size_t max_depth = 1024;
+};
+
+__attribute__((visibility("default"))) Value parse(std::string_view json);
+__attribute__((visibility("default"))) Value parse(std::string_view json, const ParseOptions& options);
+__attribute__((visibility("default"))) Value parse(const char* data, size_t size);
+// Parses a file in place through a read-only memory mapping
+__attribute__((visibility("default"))) Value parse_file(const std::string& path);
+// Name of the stage 1 kernel ParseMode::indexed uses on this CPU
+__attribute__((visibility("default"))) const char* simd_kernel();
+
+// Monotonic allocator: memory is handed out by bumping a pointer and is
+// only given back all at once by reset() or the destructor.
+class __attribute__((visibility("default"))) Arena {
+public:
+    explicit Arena(size_t block_size = 64 * 1024) : block_size(block_size) {}
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t(align) - 1);
+        if (cur && p + size <= reinterpret_cast<uintptr_t>(end)) {
+            cur = reinterpret_cast<char*>(p + size);
+            return reinterpret_cast<void*>(p);
+        }
+        return allocate_slow(size, align);
+    }
+
+    // Releases everything at once. Blocks are merged into one big enough for
+    // what was used, so a reused arena settles at a single allocation.
+    void reset();
+
+    size_t capacity() const { return total; }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    void* allocate_slow(size_t size, size_t align);
+    void add_block(size_t size);
+    void release();
+
+    size_t block_size;
+    size_t total = 0;
+    Block* blocks = nullptr;
+    char* cur = nullptr;
+    char* end = nullptr;
+};
+
+namespace detail {
+
+enum class NodeType : uint8_t { null, boolean, integer, unsigned_integer, floating, string, array, object };
+
+struct Member;
+
+// Arena node. Arrays and objects point at their children, which are stored
+// contiguously in the arena.
+struct Node {
+    NodeType type;
+    uint32_t size; // string length, element or member count
+    union {
+        bool b;
+        int64_t i;
+        uint64_t u;
+        double d;
+        const char* s;
+        const Node* elements;
+        const Member* members;
+    };
+};
+
+struct Member {
+    const char* key;
+    uint32_t key_size;
+    Node value;
+};
+
+} // namespace detail
+
+class Element;
+
+// Read-only view of an array in a Document
+class ArrayView {
+public:
+    class iterator {
+    public:
+        explicit iterator(const detail::Node* n) : node(n) {}
+        Element operator*() const;
+        iterator& operator++() { ++node; return *this; }
+        bool operator==(const iterator& other) const { return node == other.node; }
+        bool operator!=(const iterator& other) const { return node != other.node; }
+    private:
+        const detail::Node* node;
+    };
+
+    explicit ArrayView(const detail::Node* n) : node(n) {}
+    size_t size() const { return node->size; }
+    bool empty() const { return node->size == 0; }
+    iterator begin() const { return iterator(node->elements); }
+    iterator end() const { return iterator(node->elements + node->size); }
+    Element operator[](size_t index) const;
+
+private:
+    const detail::Node* node;
+};
+
+// Read-only view of an object in a Document, in document order
+class ObjectView {
+public:
+    class iterator {
+    public:
+        explicit iterator(const detail::Member* m) : member(m) {}
+        std::pair<std::string_view, Element> operator*() const;
+        iterator& operator++() { ++member; return *this; }
+        bool operator==(const iterator& other) const { return member == other.member; }
+        bool operator!=(const iterator& other) const { return member != other.member; }
+    private:
+        const detail::Member* member;
+    };
+
+    explicit ObjectView(const detail::Node* n) : node(n) {}
+    size_t size() const { return node->size; }
+    bool empty() const { return node->size == 0; }
+    iterator begin() const { return iterator(node->members); }
+    iterator end() const { return iterator(node->members + node->size); }
+
+private:
+    const detail::Node* node;
+};
+
+// Read-only handle to a value stored in a Document. Mirrors the read side of
+// Value, strings are returned as views into the arena.
+class __attribute__((visibility("default"))) Element {
+public:
+    explicit Element(const detail::Node* n) : node(n) {}
+
+    // Type checks
+    bool is_object() const { return node->type == detail::NodeType::object; }
+    bool is_array()  const { return node->type == detail::NodeType::array; }
+    bool is_string() const { return node->type == detail::NodeType::string; }
+    bool is_number() const { return is_int() || node->type == detail::NodeType::floating; }
+    bool is_int()    const { return node->type == detail::NodeType::integer || node->type == detail::NodeType::unsigned_integer; }
+    bool is_bool()   const { return node->type == detail::NodeType::boolean; }
+    bool is_null()   const { return node->type == detail::NodeType::null; }
+
+    // Getters
+    ArrayView as_array() const { expect(is_array(), "an array"); return ArrayView(node); }
+    ObjectView as_object() const { expect(is_object(), "an object"); return ObjectView(node); }
+    std::string_view as_string() const { expect(is_string(), "a string"); return {node->s, node->size}; }
+    double as_number() const {
+        if (node->type == detail::NodeType::integer) return static_cast<double>(node->i);
+        if (node->type == detail::NodeType::unsigned_integer) return static_cast<double>(node->u);
+        expect(node->type == detail::NodeType::floating, "a number");
+        return node->d;
+    }
+    int64_t as_int() const {
+        expect(is_int(), "an integer");
+        if (node->type == detail::NodeType::unsigned_integer) throw std::out_of_range("Integer out of range");
+        return node->i;
+    }
+    uint64_t as_uint() const {
+        expect(is_int(), "an integer");
+        if (node->type == detail::NodeType::unsigned_integer) return node->u;
+        if (node->i < 0) throw std::out_of_range("Integer out of range");
+        return static_cast<uint64_t>(node->i);
+    }
+    bool as_bool() const { expect(is_bool(), "a bool"); return node->b; }
+
+    // Safe getters
+    std::optional<double> try_get_number() const { return is_number() ? std::make_optional(as_number()) : std::nullopt; }
+    std::optional<int64_t> try_get_int() const { return node->type == detail::NodeType::integer ? std::make_optional(node->i) : std::nullopt; }
+    std::optional<std::string_view> try_get_string() const { return is_string() ? std::make_optional(as_string()) : std::nullopt; }
+    std::optional<bool> try_get_bool() const { return is_bool() ? std::make_optional(as_bool()) : std::nullopt; }
+
+    // Element count of arrays and objects, length of strings
+    size_t size() const { return node->size; }
+
+    // Lookups throw when the key or index is missing, like const Value
+    Element operator[](std::string_view key) const;
+    Element operator[](size_t index) const {
+        expect(is_array(), "an array");
+        if (index >= node->size) throw std::out_of_range("Array index out of range");
+        return Element(node->elements + index);
+    }
+    std::optional<Element> find(std::string_view key) const;
+
+    // Deep copy into a standalone Value
+    Value to_value() const;
+
+private:
+    void expect(bool ok, const char* what) const {
+        if (!ok) throw std::runtime_error(std::string("Element is not ") + what);
+    }
+
+    const detail::Node* node;
+};
+
+inline Element ArrayView::iterator::operator*() const { return Element(node); }
+inline Element ArrayView::operator[](size_t index) const {
+    if (index >= node->size) throw std::out_of_range("Array index out of range");
+    return Element(node->elements + index);
+}
+inline std::pair<std::string_view, Element> ObjectView::iterator::operator*() const {
+    return {std::string_view(member->key, member->key_size), Element(&member->value)};
+}
+
+// Parsed document whose nodes, keys and strings all live in one arena.
+// Parsing again releases the previous tree in one step and reuses the
+// memory, so a Document kept around for a request loop stops allocating
+// once it has seen its largest input. Elements are invalidated by the next
+// parse() and by destroying the Document.
+class __attribute__((visibility("default"))) Document {
+public:
+    explicit Document(size_t block_size = 64 * 1024) : arena(block_size) {}
+
+    Element parse(std::string_view json, const ParseOptions& options = {});
+    Element root() const;
+
+    Arena& get_arena() { return arena; }
+
+private:
+    Arena arena;
+    const detail::Node* root_node = nullptr;
+    // Children of the arrays and objects still being parsed
+    std::vector<detail::Node> node_stack;
+    std::vector<detail::Member> member_stack;
+    std::vector<uint32_t> index;
+};
+
+class LazyDocument;
+class LazyValue;
+
+// Elements of a lazy array, stepping over nested values without decoding them
+class __attribute__((visibility("default"))) LazyArray {
+public:
+    class iterator {
+    public:
+        iterator(const LazyDocument* d, uint32_t t) : doc(d), token(t) {}
+        LazyValue operator*() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return token == other.token; }
+        bool operator!=(const iterator& other) const { return token != other.token; }
+    private:
+        const LazyDocument* doc;
+        uint32_t token;
+    };
+
+    LazyArray(const LazyDocument* d, uint32_t t) : doc(d), token(t) {}
+    iterator begin() const;
+    iterator end() const;
+
+private:
+    const LazyDocument* doc;
+    uint32_t token;
+};
+
+// Members of a lazy object in document order. Keys are decoded, values are not.
+class __attribute__((visibility("default"))) LazyObject {
+public:
+    class iterator {
+    public:
+        iterator(const LazyDocument* d, uint32_t t) : doc(d), token(t) {}
+        std::pair<std::string, LazyValue> operator*() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return token == other.token; }
+        bool operator!=(const iterator& other) const { return token != other.token; }
+    private:
+        const LazyDocument* doc;
+        uint32_t token;
+    };
+
+    LazyObject(const LazyDocument* d, uint32_t t) : doc(d), token(t) {}
+    iterator begin() const;
+    iterator end() const;
+
+private:
+    const LazyDocument* doc;
+    uint32_t token;
+};
+
+// Handle to a value in a LazyDocument. Nothing is decoded until a getter
+// asks for it, and scalars are only checked then, so a malformed number or
+// literal in a field that is never read goes unnoticed.
+class __attribute__((visibility("default"))) LazyValue {
+public:
+    LazyValue(const LazyDocument* d, uint32_t t) : doc(d), token(t) {}
+
+    // Type checks, from the first character of the value
+    bool is_object() const { return first() == '{'; }
+    bool is_array()  const { return first() == '['; }
+    bool is_string() const { return first() == '"'; }
+    bool is_number() const { char c = first(); return c == '-' || (c >= '0' && c <= '9'); }
+    bool is_bool()   const { char c = first(); return c == 't' || c == 'f'; }
+    bool is_null()   const { return first() == 'n'; }
+    // Decodes the number to tell an integer from a double
+    bool is_int() const;
+
+    // Getters, decoding the value on every call
+    LazyArray as_array() const { expect(is_array(), "an array"); return LazyArray(doc, token); }
+    LazyObject as_object() const { expect(is_object(), "an object"); return LazyObject(doc, token); }
+    std::string as_string() const;
+    double as_number() const;
+    // Exact 64-bit integers, as Element::as_int and as_uint
+    int64_t as_int() const;
+    uint64_t as_uint() const;
+    bool as_bool() const;
+
+    // Safe getters
+    std::optional<double> try_get_number() const { return is_number() ? std::make_optional(as_number()) : std::nullopt; }
+    std::optional<std::string> try_get_string() const { return is_string() ? std::make_optional(as_string()) : std::nullopt; }
+    std::optional<bool> try_get_bool() const { return is_bool() ? std::make_optional(as_bool()) : std::nullopt; }
+
+    // Element count of arrays and objects, found by walking them
+    size_t size() const;
+
+    // Lookups throw when the key or index is missing, like const Value
+    LazyValue operator[](std::string_view key) const;
+    LazyValue operator[](size_t index) const;
+    std::optional<LazyValue> find(std::string_view key) const;
+
+    // JSON text of the value, a view into the input
+    std::string_view raw() const;
+
+    // Decodes the whole subtree into a standalone Value
+    Value to_value() const;
+
+private:
+    char first() const;
+    detail::Number number() const;
+    void expect(bool ok, const char* what) const {
+        if (!ok) throw std::runtime_error(std::string("LazyValue is not ") + what);
+    }
+
+    const LazyDocument* doc;
+    uint32_t token;
+};
+
+inline LazyValue LazyArray::iterator::operator*() const { return LazyValue(doc, token); }
+
+// On-demand document. parse() only checks the structure: it indexes the
+// input with the stage 1 scanner and matches brackets, so skipping a
+// subtree later is a single jump. Strings, numbers and nested values are
+// decoded when they are accessed. The input is not copied and has to
+// outlive the document; LazyValues are invalidated by the next parse().
+class __attribute__((visibility("default"))) LazyDocument {
+public:
+    LazyValue parse(std::string_view json);
+    LazyValue root() const;
+
+private:
+    friend class LazyValue;
+    friend class LazyArray;
+    friend class LazyObject;
+
+    // Token after the value that starts at token t
+    uint32_t skip(uint32_t t) const {
+        char c = input[index[t]];
+        return c == '{' || c == '[' ? jump[t] : t + 1;
+    }
+    // Start of the token, or the end of the input past the last one
+    size_t position(uint32_t t) const { return t < index.size() ? index[t] : input.size(); }
+    // End of the scalar at token t, trailing whitespace excluded
+    size_t scalar_end(uint32_t t) const;
+    void validate();
+
+    std::string_view input;
+    std::vector<uint32_t> index;
+    // Token after the matching bracket, for tokens that open a container
+    std::vector<uint32_t> jump;
+    std::vector<uint32_t> open;
+};
+
+// Binary encoding of a Value that can be queried in place, so a document
+// cached on disk is loaded with an mmap instead of a parse. The layout is
+// position independent: a header, then tagged nodes addressed by 32-bit
+// offsets from the start of the buffer, children before their parents.
+// Strings are length prefixed and objects keep their members in insertion
+// order plus an index sorted by key for binary search. Numbers keep their
+// exact type, so decode_binary(encode_binary(v)) == v and serializes to the
+// same text.
+__attribute__((visibility("default"))) std::string encode_binary(const Value& v);
+__attribute__((visibility("default"))) void encode_binary_to(std::string& out, const Value& v);
+// Throws when arrays and objects nest deeper than max_depth, as parse() does
+__attribute__((visibility("default"))) Value decode_binary(std::string_view bytes, size_t max_depth = 1024);
+// Writes encode_binary(v) to path
+__attribute__((visibility("default"))) void save_binary(const std::string& path, const Value& v);
+
+class BinaryValue;
+
+// Elements of a binary array
+class __attribute__((visibility("default"))) BinaryArray {
+public:
+    class iterator {
+    public:
+        iterator(const BinaryArray* a, size_t i) : array(a), index(i) {}
+        BinaryValue operator*() const;
+        iterator& operator++() { ++index; return *this; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    private:
+        const BinaryArray* array;
+        size_t index;
+    };
+
+    BinaryArray(std::string_view bytes, uint32_t offset);
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, count); }
+    BinaryValue operator[](size_t index) const;
+
+private:
+    std::string_view bytes;
+    uint32_t offset;
+    uint32_t count;
+};
+
+// Members of a binary object, in insertion order
+class __attribute__((visibility("default"))) BinaryObject {
+public:
+    class iterator {
+    public:
+        iterator(const BinaryObject* o, size_t i) : object(o), index(i) {}
+        std::pair<std::string_view, BinaryValue> operator*() const;
+        iterator& operator++() { ++index; return *this; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    private:
+        const BinaryObject* object;
+        size_t index;
+    };
+
+    BinaryObject(std::string_view bytes, uint32_t offset);
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, count); }
+    // Binary search of the sorted key index
+    std::optional<BinaryValue> find(std::string_view key) const;
+
+    std::string_view key(size_t index) const;
+    BinaryValue value(size_t index) const;
+
+private:
+    std::string_view bytes;
+    uint32_t offset;
+    uint32_t count;
+};
+
+// Handle to a value inside binary encoded bytes, read in place. Offsets are
+// checked on every access, so corrupt input throws instead of reading out of
+// bounds.
+class __attribute__((visibility("default"))) BinaryValue {
+public:
+    BinaryValue(std::string_view bytes, uint32_t offset);
+
+    // Type checks
+    bool is_object() const;
+    bool is_array()  const;
+    bool is_string() const;
+    bool is_number() const;
+    bool is_int()    const;
+    bool is_bool()   const;
+    bool is_null()   const;
+
+    // Getters, strings are views into the bytes
+    BinaryArray as_array() const;
+    BinaryObject as_object() const;
+    std::string_view as_string() const;
+    double as_number() const;
+    int64_t as_int() const;
+    uint64_t as_uint() const;
+    bool as_bool() const;
+
+    // Element or member count of arrays and objects
+    size_t size() const;
+
+    // Lookups throw when the key or index is missing, like const Value
+    BinaryValue operator[](std::string_view key) const;
+    BinaryValue operator[](size_t index) const;
+    std::optional<BinaryValue> find(std::string_view key) const;
+
+    // Decodes the subtree into a standalone Value. Corrupt bytes can nest
+    // without limit, so deeper than max_depth throws.
+    Value to_value(size_t max_depth = 1024) const;
+
+private:
+    uint8_t tag() const;
+    Value decode(size_t depth, size_t max_depth) const;
+
+    std::string_view bytes;
+    uint32_t offset;
+};
+
+inline BinaryValue BinaryArray::iterator::operator*() const { return (*array)[index]; }
+inline std::pair<std::string_view, BinaryValue> BinaryObject::iterator::operator*() const {
+    return {object->key(index), object->value(index)};
+}
+
+// Binary encoded bytes, either viewed in memory or mapped from a file
+class __attribute__((visibility("default"))) BinaryDocument {
+public:
+    // bytes must outlive the document
+    explicit BinaryDocument(std::string_view bytes);
+    // Maps a file written by save_binary, read-only
+    static BinaryDocument open(const std::string& path);
+
+    BinaryValue root() const;
+    std::string_view data() const { return bytes; }
+
+private:
+    std::shared_ptr<const void> mapping; // keeps an mmap alive
+    std::string_view bytes;
+    uint32_t root_offset;
+};
+
+// Query compiled once and evaluated against many documents. Accepts RFC 6901
+// JSON pointers ("/payload/items/3/price", with ~0 and ~1 escapes) and a
+// JSONPath subset starting with '$': .name, ['name'], [3], and the
+// wildcards .* and [*]. Lookups return nullptr or nullopt on a miss instead
+// of throwing, and find() on a Value doesn't allocate.
+class __attribute__((visibility("default"))) Path {
+public:
+    // Throws std::runtime_error on malformed syntax
+    explicit Path(std::string_view path);
+
+    // First match, in document order
+    const Value* find(const Value& root) const;
+    Value* find(Value& root) const;
+    std::optional<Element> find(Element root) const;
+    // Appends every match, for paths with wildcards
+    void find_all(const Value& root, std::vector<const Value*>& out) const;
+    void find_all(Element root, std::vector<Element>& out) const;
+
+    // Streaming: walks the JSON text, skipping everything off the path, and
+    // only decodes the matches. extract() gives what find() gives on the
+    // parsed text, so of repeated keys the last one counts; extract_all()
+    // passes every match in the text, repeated keys included.
+    std::optional<Value> extract(std::string_view json, const ParseOptions& options = {}) const;
+    void extract_all(std::string_view json, const std::function<void(Value&&)>& fn, const ParseOptions& options = {}) const;
+
+    size_t size() const { return steps.size(); }
+
+private:
+    struct Step {
+        std::string key;
+        size_t index;  // key as an array index, npos if it isn't one
+        bool wildcard;
+    };
+
+    template <class V>
+    V* find_from(V* v, size_t step) const;
+    std::optional<Element> find_from(Element e, size_t step) const;
+    // Returns false once fn asks to stop
+    bool extract_from(Reader& r, size_t step, const std::function<bool(Value&&)>& fn) const;
+    std::optional<Value> extract_first(Reader& r, size_t step) const;
+
+    std::vector<Step> steps;
+};
+
+// Counters from the instrumented build (meson configure -Dstats=true). A
+// default build compiles the instrumentation out: stats_enabled() is false,
+// stats() stays zero and the hook is never called.
+struct Stats {
+    uint64_t calls = 0;            // top-level API calls
+    // JSON text read and written; for JSONL, the records without the line
+    // breaks between them
+    uint64_t bytes_parsed = 0;
+    uint64_t bytes_serialized = 0;
+    // Nodes parsed, by type
+    uint64_t nulls = 0;
+    uint64_t bools = 0;
+    uint64_t integers = 0;
+    uint64_t doubles = 0;
+    uint64_t strings = 0;
+    uint64_t arrays = 0;
+    uint64_t objects = 0;
+    uint32_t max_depth = 0;
+    // Heap blocks held by the trees built and their size; for a Document,
+    // how much its arena grew
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    // Wall time of parse and serialize calls, in seconds
+    double parse_time = 0;
+    double serialize_time = 0;
+    // Phases of parse_jsonl and serialize_jsonl
+    double split_time = 0;         // cutting the input into chunks
+    double parallel_time = 0;      // wall time of the parallel section
+    double task_time = 0;          // summed over tasks
+    double max_task_time = 0;
+    double merge_time = 0;         // joining per-task results
+    uint64_t tasks = 0;
+    uint32_t threads = 0;
+
+    // Share of the parallel section the threads spent in tasks, 0 to 1
+    double utilization() const { return parallel_time > 0 && threads ? task_time / (parallel_time * threads) : 0; }
+    // Slowest task against the mean, 1 is perfectly balanced
+    double imbalance() const { return tasks && task_time > 0 ? max_task_time * tasks / task_time : 0; }
+
+    __attribute__((visibility("default"))) Stats& operator+=(const Stats& other);
+};
+
+// Called after every top-level call with its own counters, on the calling
+// thread. api names the call, e.g. "parse" or "parse_jsonl".
+using StatsHook = std::function<void(const char* api, const Stats& call)>;
+
+__attribute__((visibility("default"))) bool stats_enabled();
+// Cumulative counters of all calls so far
+__attribute__((visibility("default"))) Stats stats();
+__attribute__((visibility("default"))) void reset_stats();
+__attribute__((visibility("default"))) void set_stats_hook(StatsHook hook);
+
+// Receives parse events from parse_sax() and StreamParser. Keys and strings
+// are views that are only valid for the duration of the call.
+class Handler {
+public:
+    virtual ~Handler() = default;
+
+    virtual void null_value() {}
+    virtual void bool_value(bool) {}
+    virtual void int_value(int64_t) {}
+    // Integers above INT64_MAX
+    virtual void uint_value(uint64_t) {}
+    virtual void double_value(double) {}
+    virtual void string_value(std::string_view) {}
+
+    virtual void start_object() {}
+    virtual void key(std::string_view) {}
+    virtual void end_object() {}
+
+    virtual void start_array() {}
+    virtual void end_array() {}
+};
+
+// Parses a document held in memory and reports it as events, without
+// building any Value
+__attribute__((visibility("default"))) void parse_sax(std::string_view json, Handler& handler, const ParseOptions& options = {});
+
+// Incremental event parser. Input can be fed in chunks split at any byte;
+// memory use is bounded by the nesting depth and the longest single token,
+// not by the size of the document.
+class __attribute__((visibility("default"))) StreamParser {
+public:
+    explicit StreamParser(Handler& handler, size_t max_depth = 1024)
+        : handler(handler), max_depth(max_depth) {}
+    // Takes validate_utf8 and max_depth from options
+    StreamParser(Handler& handler, const ParseOptions& options)
+        : handler(handler), max_depth(options.max_depth), validate_utf8(options.validate_utf8) {}
+
+    // Parses the next chunk, throws on malformed input
+    void feed(std::string_view chunk);
+    // Signals end of input, throws if the document is incomplete
+    void finish();
+    // Forgets all state so a new document can be fed
+    void reset();
+
+    // Bytes fed so far
+    size_t position() const { return offset; }
+
+private:
+    enum class State { value, first_value, key, first_key, colon, after_value, done };
+    enum class Token { none, string, key, number, literal };
+
+    size_t continue_token(const char* p, size_t n);
+    size_t start_string(const char* p, size_t n, size_t i, Token kind);
+    size_t start_scalar(const char* p, size_t n, size_t i, Token kind);
+    void emit_string(const char* p, size_t n, size_t base, Token kind);
+    void emit_scalar(const char* p, size_t n, size_t base, Token kind);
+    void open(char bracket);
+    void close(char bracket, size_t at);
+    void value_done() { state = stack.empty() ? State::done : State::after_value; }
+
+    Handler& handler;
+    size_t max_depth;
+    bool validate_utf8 = true;
+    std::vector<char> stack;   // open containers, '{' or '['
+    State state = State::value;
+    Token token = Token::none; // token split across chunks
+    bool escape = false;       // pending string ended on a backslash
+    size_t token_start = 0;
+    size_t offset = 0;
+    std::string partial;       // raw bytes of the split token
+    std::string scratch;       // decoded string contents
+};
+
+// Runs task(0) ... task(count - 1), possibly in parallel, and returns once
+// all of them have finished. Lets the JSONL functions run on an
+// application's own thread pool.
+using Executor = std::function<void(size_t count, const std::function<void(size_t)>& task)>;
+
+// Persistent worker threads. Each run() spreads its tasks over per-worker
+// queues and workers that run out of work steal from the others, so a few
+// expensive tasks don't leave the rest of the pool idle. The calling thread
+// works too, and tasks must not call run() on the same pool.
+class __attribute__((visibility("default"))) ThreadPool {
+public:
+    // threads counts the calling thread, 0 means hardware_concurrency()
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+
+    // Rethrows the first exception a task threw, after all tasks are done
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    // Process-wide pool created on first use
+    static ThreadPool& shared();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+// A JSONL line that didn't parse
+struct JsonlError {
+    size_t line = 0;       // 1-based, empty lines count
+    size_t offset = 0;     // byte offset of the line in the input
+    std::string_view text; // the line itself, points into the input
+    std::string message;   // positions in it are relative to the line
+};
+
+struct ParallelOptions {
+    ThreadPool* pool = nullptr;      // nullptr uses ThreadPool::shared()
+    Executor executor;               // when set, used instead of any pool
+    // Parsing
+    size_t serial_threshold = 256 * 1024; // smaller inputs (bytes) run on the calling thread
+    size_t chunk_size = 0;           // bytes per task, 0 picks one from the input and pool size
+    ParseOptions parse;
+    bool intern_keys = true;         // each task interns keys in its own KeyTable
+    // Bad lines. By default parse_jsonl throws the first one in the input,
+    // prefixed with its line number. With skip_errors it leaves them out,
+    // keeps going and hands each to on_error, in input order, at the end.
+    bool skip_errors = false;
+    std::function<void(const JsonlError&)> on_error;
+    // Serializing
+    size_t serial_records = 1024;    // fewer records run on the calling thread
+    size_t batch_records = 0;        // records per task, 0 picks one from the input and pool size
+};
+
+// Receives serialized output piece by piece, in order
+using Sink = std::function<void(std::string_view)>;
+
+__attribute__((visibility("default"))) std::string serialize_jsonl(const std::vector<Value>& v, const ParallelOptions& options = {});
+// Streams the lines to sink or fd as they are ready, so the whole output is
+// never held in memory
+__attribute__((visibility("default"))) void serialize_jsonl_to(const Sink& sink, const std::vector<Value>& v, const ParallelOptions& options = {});
+__attribute__((visibility("default"))) void serialize_jsonl_to(int fd, const std::vector<Value>& v, const ParallelOptions& options = {});
+__attribute__((visibility("default"))) std::vector<Value> parse_jsonl(std::string_view json, const ParallelOptions& options = {});
+
+// One non-empty line of parse_jsonl_lines
+struct JsonlLine {
+    size_t line = 0;       // 1-based, empty lines count
+    size_t offset = 0;     // byte offset of the line in the input
+    Value value;           // null when the line failed
+    std::string error;     // empty when it parsed
+    bool ok() const { return error.empty(); }
+};
+
+// Like parse_jsonl, but never throws for a bad line: every non-empty line
+// gets a result, in order, with either its value or its error
+__attribute__((visibility("default"))) std::vector<JsonlLine> parse_jsonl_lines(std::string_view jsonl, const ParallelOptions& options = {});
+// Parses one large document on several threads. The members of the root
+// array or object, and of any member bigger than a chunk, are found on the
+// structural index and parsed as separate tasks, then put back in order.
+// Gives the same Value and the same first error as parse(); inputs below
+// serial_threshold, or with a malformed root, are simply parsed serially.
+__attribute__((visibility("default"))) Value parse_parallel(std::string_view json, const ParallelOptions& options = {});
+
+namespace detail {
+
+// Drives parse_jsonl_as(): calls count with the number of chunks, then
+// parse_line(i, line) for every non-empty line of chunk i, chunks in
+// parallel. Bad lines are numbered, thrown or skipped as in parse_jsonl.
+__attribute__((visibility("default"))) void parse_jsonl_chunks(std::string_view jsonl, const ParallelOptions& options,
+                                                               const std::function<void(size_t)>& count,
+                                                               const std::function<void(size_t, std::string_view)>& parse_line);
+
+} // namespace detail
+
+// Reads JSONL records from a file descriptor in fixed-size chunks and hands
+// them out one at a time or in batches. Peak memory is the read buffer,
+// which only grows for lines longer than it, plus the records handed out.
+// Empty lines are skipped and a trailing '\r' is stripped.
+class __attribute__((visibility("default"))) JsonlReader {
+public:
+    // Reads from fd, which stays owned by the caller
+    explicit JsonlReader(int fd, size_t buffer_size = 1 << 20, const ParseOptions& options = {});
+    // Opens path for reading and closes it on destruction
+    explicit JsonlReader(const std::string& path, size_t buffer_size = 1 << 20, const ParseOptions& options = {});
+    ~JsonlReader();
+    JsonlReader(const JsonlReader&) = delete;
+    JsonlReader& operator=(const JsonlReader&) = delete;
+
+    // Parses the next record into out, returns false at end of input
+    bool next(Value& out);
+    // Appends up to max_records records to out, returns how many were added
+    size_t next_batch(std::vector<Value>& out, size_t max_records);
+    // Next non-empty line without parsing it, valid until the next call
+    std::optional<std::string_view> next_line();
+
+    // 1-based line number of the last line returned
+    size_t line_number() const { return line; }
+
+private:
+    bool fill();
+
+    int fd;
+    bool owns_fd;
+    ParseOptions options;
+    KeyTable keys;     // used unless options name a table
+    std::vector<char> buf;
+    size_t begin = 0;
+    size_t end = 0;
+    bool eof = false;
+    size_t line = 0;
+};
 
-__attribute__((visibility("default"))) std::string serialize_jsonl(const std::vector<Value&> v);
-__attribute__((visibility("default"))) std::vector<Value> parse_jsonl(const std::string& json);
+// Calls fn for every record of a JSONL file, in order
+__attribute__((visibility("default"))) void for_each_jsonl(const std::string& path, const std::function<void(Value&&)>& fn, size_t buffer_size = 1 << 20);
 
 } // namespace jsonn
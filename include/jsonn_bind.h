@@ -0,0 +1,383 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+#include "jsonn.h"
+#include <array>
+#include <limits>
+#include <tuple>
+
+// Binds plain structs to JSON. List the members once at namespace scope,
+// next to the struct:
+//
+//     struct Point { int x; int y; std::string label; };
+//     JSONN_DEFINE(Point, x, y, label)
+//
+// and parse_as<Point>(), serialize_as() and parse_jsonl_as<Point>() read
+// and write it directly, without building a Value tree. Members may be
+// bools, numbers, std::string, std::vector, std::optional, jsonn::Value or
+// other bound structs. Unknown keys are skipped and missing ones keep their
+// default. More types can be bound by specializing jsonn::Bind.
+
+namespace jsonn {
+
+// Pull parser over one JSON text, the bindings read through it
+class __attribute__((visibility("default"))) Reader {
+public:
+    explicit Reader(std::string_view json, const ParseOptions& options = {});
+
+    // First character of the next value: '{', '[', '"', 't' or 'f', 'n',
+    // or '0' for any number
+    char peek();
+
+    // Consumes a null and returns true if the next value is one
+    bool read_null();
+    bool read_bool();
+    int64_t read_int();
+    uint64_t read_uint();
+    double read_double();
+    // Valid until the next read
+    std::string_view read_string();
+    Value read_value();
+    // Skips the next value without decoding it
+    void skip();
+
+    // Iteration: begin_object() then next_key() until it returns false,
+    // reading each member's value in between. Arrays work the same way.
+    void begin_object();
+    bool next_key(std::string_view& key);
+    void begin_array();
+    bool next_element();
+
+    // Checks that nothing but whitespace follows
+    void finish();
+
+    size_t position() const { return pos; }
+
+private:
+    char next();
+    [[noreturn]] void fail(const std::string& what) const;
+
+    std::string_view in;
+    size_t pos = 0;
+    bool validate_utf8;
+    bool first = false;  // no member or element read yet in the open container
+    std::string scratch; // decoded string contents
+};
+
+namespace detail {
+
+// Serializer pieces shared with the bindings
+__attribute__((visibility("default"))) void write_string(std::string& out, std::string_view s);
+__attribute__((visibility("default"))) void write_int(std::string& out, int64_t i);
+__attribute__((visibility("default"))) void write_uint(std::string& out, uint64_t u);
+__attribute__((visibility("default"))) void write_double(std::string& out, double d);
+
+} // namespace detail
+
+// Reads and writes one type. Specializations provide
+//     static void read(Reader& r, T& out);
+//     static void write(std::string& out, const T& v);
+template <class T, class = void>
+struct Bind;
+
+template <>
+struct Bind<bool> {
+    static void read(Reader& r, bool& out) { out = r.read_bool(); }
+    static void write(std::string& out, bool v) { v ? out.append("true", 4) : out.append("false", 5); }
+};
+
+template <class T>
+struct Bind<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static void read(Reader& r, T& out) {
+        if constexpr (std::is_signed_v<T>) {
+            int64_t i = r.read_int();
+            if (i < std::numeric_limits<T>::min() || i > std::numeric_limits<T>::max()) {
+                throw std::out_of_range("Integer out of range at position " + std::to_string(r.position()));
+            }
+            out = static_cast<T>(i);
+        } else {
+            uint64_t u = r.read_uint();
+            if (u > std::numeric_limits<T>::max()) {
+                throw std::out_of_range("Integer out of range at position " + std::to_string(r.position()));
+            }
+            out = static_cast<T>(u);
+        }
+    }
+    static void write(std::string& out, T v) {
+        if constexpr (std::is_signed_v<T>) {
+            detail::write_int(out, v);
+        } else {
+            detail::write_uint(out, v);
+        }
+    }
+};
+
+template <class T>
+struct Bind<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static void read(Reader& r, T& out) { out = static_cast<T>(r.read_double()); }
+    static void write(std::string& out, T v) { detail::write_double(out, static_cast<double>(v)); }
+};
+
+template <>
+struct Bind<std::string> {
+    static void read(Reader& r, std::string& out) { out.assign(r.read_string()); }
+    static void write(std::string& out, const std::string& v) { detail::write_string(out, v); }
+};
+
+template <>
+struct Bind<Value> {
+    static void read(Reader& r, Value& out) { out = r.read_value(); }
+    static void write(std::string& out, const Value& v) { serialize_to(out, v); }
+};
+
+template <class T>
+struct Bind<std::vector<T>> {
+    static void read(Reader& r, std::vector<T>& out) {
+        out.clear();
+        r.begin_array();
+        while (r.next_element()) {
+            if constexpr (std::is_same_v<T, bool>) {
+                // vector<bool> has no references to read into
+                bool b = false;
+                Bind<bool>::read(r, b);
+                out.push_back(b);
+            } else {
+                Bind<T>::read(r, out.emplace_back());
+            }
+        }
+    }
+    static void write(std::string& out, const std::vector<T>& v) {
+        out.push_back('[');
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (i) out.push_back(',');
+            Bind<T>::write(out, v[i]);
+        }
+        out.push_back(']');
+    }
+};
+
+// null reads as an empty optional, and an empty optional writes null
+template <class T>
+struct Bind<std::optional<T>> {
+    static void read(Reader& r, std::optional<T>& out) {
+        if (r.read_null()) {
+            out.reset();
+        } else {
+            Bind<T>::read(r, out.emplace());
+        }
+    }
+    static void write(std::string& out, const std::optional<T>& v) {
+        if (v) {
+            Bind<T>::write(out, *v);
+        } else {
+            out.append("null", 4);
+        }
+    }
+};
+
+// Member of a struct bound with JSONN_DEFINE
+template <class C, class M>
+struct Field {
+    std::string_view name;
+    M C::*member;
+};
+
+// Structs bound with JSONN_DEFINE, found through the jsonn_fields() it
+// declares next to the struct
+template <class T>
+struct Bind<T, std::void_t<decltype(jsonn_fields(static_cast<const T*>(nullptr)))>> {
+    static constexpr auto fields = jsonn_fields(static_cast<const T*>(nullptr));
+    static constexpr size_t count = std::tuple_size_v<std::remove_const_t<decltype(fields)>>;
+
+    static void read(Reader& r, T& out) {
+        r.begin_object();
+        std::string_view key;
+        size_t expected = 0;
+        while (r.next_key(key)) {
+            size_t i = find(key, expected);
+            if (i == count) {
+                r.skip();
+                continue;
+            }
+            read_member(r, out, i, std::make_index_sequence<count>{});
+            expected = i + 1;
+        }
+    }
+
+    static void write(std::string& out, const T& v) {
+        out.push_back('{');
+        write_members(out, v, std::make_index_sequence<count>{});
+        out.push_back('}');
+    }
+
+private:
+    // Keys usually arrive in declaration order, so the member after the
+    // last one read is tried before searching
+    static size_t find(std::string_view key, size_t expected) {
+        if (expected < count && name(expected) == key) return expected;
+        for (size_t i = 0; i < count; ++i) {
+            if (name(i) == key) return i;
+        }
+        return count;
+    }
+
+    static std::string_view name(size_t i) {
+        static constexpr auto names = std::apply([](const auto&... f) {
+            return std::array<std::string_view, count>{f.name...};
+        }, fields);
+        return names[i];
+    }
+
+    template <size_t... I>
+    static void read_member(Reader& r, T& out, size_t i, std::index_sequence<I...>) {
+        ((i == I ? read_field(r, out, std::get<I>(fields)) : void()), ...);
+    }
+
+    template <class M>
+    static void read_field(Reader& r, T& out, const Field<T, M>& f) {
+        Bind<M>::read(r, out.*f.member);
+    }
+
+    template <size_t... I>
+    static void write_members(std::string& out, const T& v, std::index_sequence<I...>) {
+        (write_field(out, v, std::get<I>(fields), I == 0), ...);
+    }
+
+    template <class M>
+    static void write_field(std::string& out, const T& v, const Field<T, M>& f, bool first) {
+        if (!first) out.push_back(',');
+        out.push_back('"');
+        out.append(f.name);
+        out.append("\":", 2);
+        Bind<M>::write(out, v.*f.member);
+    }
+};
+
+template <class T>
+void parse_into(std::string_view json, T& out, const ParseOptions& options = {}) {
+    Reader r(json, options);
+    Bind<T>::read(r, out);
+    r.finish();
+}
+
+template <class T>
+T parse_as(std::string_view json, const ParseOptions& options = {}) {
+    T out{};
+    parse_into(json, out, options);
+    return out;
+}
+
+template <class T>
+void serialize_as_to(std::string& out, const T& v) {
+    Bind<T>::write(out, v);
+}
+
+template <class T>
+std::string serialize_as(const T& v) {
+    std::string out;
+    Bind<T>::write(out, v);
+    return out;
+}
+
+// parse_jsonl() straight into structs. Chunks are parsed in parallel and
+// bad lines are numbered, thrown or skipped the same way.
+template <class T>
+std::vector<T> parse_jsonl_as(std::string_view jsonl, const ParallelOptions& options = {}) {
+    std::vector<std::vector<T>> parts;
+    auto count = [&](size_t n) { parts.resize(n); };
+    detail::parse_jsonl_chunks(jsonl, options, count, [&](size_t i, std::string_view line) {
+        T record{};
+        parse_into(line, record, options.parse);
+        parts[i].push_back(std::move(record));
+    });
+    if (parts.size() == 1) return std::move(parts[0]);
+
+    std::vector<T> result;
+    size_t total = 0;
+    for (auto& part : parts) total += part.size();
+    result.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+} // namespace jsonn
+
+#define JSONN_EXPAND(x) x
+#define JSONN_FIELD(f) ::jsonn::Field<jsonn_type, decltype(jsonn_type::f)>{#f, &jsonn_type::f}
+#define JSONN_FIELDS_1(f) JSONN_FIELD(f)
+#define JSONN_FIELDS_2(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_1(__VA_ARGS__))
+#define JSONN_FIELDS_3(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_2(__VA_ARGS__))
+#define JSONN_FIELDS_4(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_3(__VA_ARGS__))
+#define JSONN_FIELDS_5(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_4(__VA_ARGS__))
+#define JSONN_FIELDS_6(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_5(__VA_ARGS__))
+#define JSONN_FIELDS_7(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_6(__VA_ARGS__))
+#define JSONN_FIELDS_8(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_7(__VA_ARGS__))
+#define JSONN_FIELDS_9(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_8(__VA_ARGS__))
+#define JSONN_FIELDS_10(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_9(__VA_ARGS__))
+#define JSONN_FIELDS_11(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_10(__VA_ARGS__))
+#define JSONN_FIELDS_12(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_11(__VA_ARGS__))
+#define JSONN_FIELDS_13(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_12(__VA_ARGS__))
+#define JSONN_FIELDS_14(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_13(__VA_ARGS__))
+#define JSONN_FIELDS_15(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_14(__VA_ARGS__))
+#define JSONN_FIELDS_16(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_15(__VA_ARGS__))
+#define JSONN_FIELDS_17(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_16(__VA_ARGS__))
+#define JSONN_FIELDS_18(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_17(__VA_ARGS__))
+#define JSONN_FIELDS_19(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_18(__VA_ARGS__))
+#define JSONN_FIELDS_20(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_19(__VA_ARGS__))
+#define JSONN_FIELDS_21(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_20(__VA_ARGS__))
+#define JSONN_FIELDS_22(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_21(__VA_ARGS__))
+#define JSONN_FIELDS_23(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_22(__VA_ARGS__))
+#define JSONN_FIELDS_24(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_23(__VA_ARGS__))
+#define JSONN_FIELDS_25(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_24(__VA_ARGS__))
+#define JSONN_FIELDS_26(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_25(__VA_ARGS__))
+#define JSONN_FIELDS_27(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_26(__VA_ARGS__))
+#define JSONN_FIELDS_28(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_27(__VA_ARGS__))
+#define JSONN_FIELDS_29(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_28(__VA_ARGS__))
+#define JSONN_FIELDS_30(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_29(__VA_ARGS__))
+#define JSONN_FIELDS_31(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_30(__VA_ARGS__))
+#define JSONN_FIELDS_32(f, ...) JSONN_FIELD(f), JSONN_EXPAND(JSONN_FIELDS_31(__VA_ARGS__))
+#define JSONN_COUNT(...) JSONN_EXPAND(JSONN_COUNT_N(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, \
+                                                    16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define JSONN_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, \
+                      _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define JSONN_CONCAT(a, b) JSONN_CONCAT_(a, b)
+#define JSONN_CONCAT_(a, b) a##b
+
+// Binds up to 32 members of Type, see the top of this file
+#define JSONN_DEFINE(Type, ...)                                                                \
+    [[maybe_unused]] inline constexpr auto jsonn_fields(const Type*) {                         \
+        using jsonn_type = Type;                                                               \
+        return std::make_tuple(JSONN_EXPAND(JSONN_CONCAT(JSONN_FIELDS_, JSONN_COUNT(__VA_ARGS__))(__VA_ARGS__))); \
+    }
@@ -0,0 +1,409 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "jsonn.h"
+#include "jsonn_mmap.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace jsonn {
+
+namespace {
+
+// Header: magic, format version, offset of the root node
+constexpr char magic[4] = {'J', 'S', 'N', 'B'};
+constexpr uint32_t version = 1;
+constexpr size_t header_size = 12;
+
+// Node tags. Containers are followed by a u32 count, arrays by that many
+// u32 child offsets, objects by (key, value) offset pairs in insertion order
+// and then u32 member indices sorted by key. Strings are a u32 length and
+// the bytes, numbers 8 little-endian bytes.
+enum Tag : uint8_t { t_null, t_false, t_true, t_int, t_uint, t_double, t_string, t_array, t_object };
+
+template <class T>
+T to_little(T v) {
+    if constexpr (std::endian::native == std::endian::big) {
+        if constexpr (sizeof(T) == 4) return __builtin_bswap32(v);
+        else return __builtin_bswap64(v);
+    }
+    return v;
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Corrupt binary document");
+}
+
+uint32_t load32(std::string_view b, size_t off) {
+    if (off > b.size() || b.size() - off < 4) corrupt();
+    uint32_t v;
+    std::memcpy(&v, b.data() + off, 4);
+    return to_little(v);
+}
+
+uint64_t load64(std::string_view b, size_t off) {
+    if (off > b.size() || b.size() - off < 8) corrupt();
+    uint64_t v;
+    std::memcpy(&v, b.data() + off, 8);
+    return to_little(v);
+}
+
+// Children are always written before their parents, so a child offset that
+// doesn't point backwards can only come from corrupt data. This also rules
+// out cycles.
+uint32_t child(std::string_view b, uint32_t parent, size_t off) {
+    uint32_t c = load32(b, off);
+    if (c >= parent || c < header_size) corrupt();
+    return c;
+}
+
+std::string_view load_string(std::string_view b, uint32_t off) {
+    if (off >= b.size() || static_cast<uint8_t>(b[off]) != t_string) corrupt();
+    uint32_t len = load32(b, off + 1);
+    if (b.size() - (off + 5) < len) corrupt();
+    return b.substr(off + 5, len);
+}
+
+// Count of the container at off, checked against the bytes it needs
+uint32_t load_count(std::string_view b, uint32_t off, size_t entry) {
+    uint32_t n = load32(b, off + 1);
+    if ((b.size() - (off + 5)) / entry < n) corrupt();
+    return n;
+}
+
+struct Encoder {
+    std::string& out;
+    size_t base;
+    std::unordered_map<std::string_view, uint32_t> keys; // keys are written once
+
+    uint32_t here() {
+        size_t pos = out.size() - base;
+        if (pos > UINT32_MAX) throw std::runtime_error("Value too large for binary encoding");
+        return static_cast<uint32_t>(pos);
+    }
+
+    void put8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+    void put32(uint32_t v) {
+        v = to_little(v);
+        out.append(reinterpret_cast<const char*>(&v), 4);
+    }
+    void put64(uint64_t v) {
+        v = to_little(v);
+        out.append(reinterpret_cast<const char*>(&v), 8);
+    }
+
+    uint32_t string(std::string_view s) {
+        if (s.size() > UINT32_MAX) throw std::runtime_error("String too long for binary encoding");
+        uint32_t at = here();
+        put8(t_string);
+        put32(static_cast<uint32_t>(s.size()));
+        out.append(s);
+        return at;
+    }
+
+    uint32_t key(std::string_view k) {
+        auto it = keys.find(k);
+        if (it != keys.end()) return it->second;
+        uint32_t at = string(k);
+        keys.emplace(k, at);
+        return at;
+    }
+
+    uint32_t node(const Value& v) {
+        switch (v.data.index()) {
+            case 0: { uint32_t at = here(); put8(t_null); return at; }
+            case 1: { uint32_t at = here(); put8(std::get<bool>(v.data) ? t_true : t_false); return at; }
+            case 2: { uint32_t at = here(); put8(t_int); put64(static_cast<uint64_t>(std::get<int64_t>(v.data))); return at; }
+            case 3: { uint32_t at = here(); put8(t_uint); put64(std::get<uint64_t>(v.data)); return at; }
+            case 4: { uint32_t at = here(); put8(t_double); put64(std::bit_cast<uint64_t>(std::get<double>(v.data))); return at; }
+            case 5: return string(std::get<std::string>(v.data));
+            case 6: {
+                const Array& a = std::get<Array>(v.data);
+                std::vector<uint32_t> children;
+                children.reserve(a.size());
+                for (const Value& e : a) children.push_back(node(e));
+                uint32_t at = here();
+                put8(t_array);
+                put32(static_cast<uint32_t>(children.size()));
+                for (uint32_t c : children) put32(c);
+                return at;
+            }
+            default: {
+                const Object& o = std::get<Object>(v.data);
+                std::vector<std::pair<uint32_t, uint32_t>> members;
+                std::vector<std::string_view> names;
+                members.reserve(o.size());
+                names.reserve(o.size());
+                for (const auto& [k, val] : o) {
+                    uint32_t value_at = node(val);
+                    members.emplace_back(key(k), value_at);
+                    names.push_back(k);
+                }
+                std::vector<uint32_t> sorted(members.size());
+                for (uint32_t i = 0; i < sorted.size(); ++i) sorted[i] = i;
+                std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+                uint32_t at = here();
+                put8(t_object);
+                put32(static_cast<uint32_t>(members.size()));
+                for (auto [k, val] : members) {
+                    put32(k);
+                    put32(val);
+                }
+                for (uint32_t i : sorted) put32(i);
+                return at;
+            }
+        }
+    }
+};
+
+} // namespace
+
+void encode_binary_to(std::string& out, const Value& v) {
+    size_t base = out.size();
+    out.append(magic, 4);
+    Encoder e{out, base, {}};
+    e.put32(version);
+    e.put32(0);
+    uint32_t root = e.node(v);
+    root = to_little(root);
+    std::memcpy(&out[base + 8], &root, 4);
+}
+
+std::string encode_binary(const Value& v) {
+    std::string out;
+    encode_binary_to(out, v);
+    return out;
+}
+
+Value decode_binary(std::string_view bytes, size_t max_depth) {
+    return BinaryDocument(bytes).root().to_value(max_depth);
+}
+
+void save_binary(const std::string& path, const Value& v) {
+    std::string bytes = encode_binary(v);
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) throw std::runtime_error("Cannot open file: " + path);
+    f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!f) throw std::runtime_error("Cannot write file: " + path);
+}
+
+// BinaryDocument
+
+BinaryDocument::BinaryDocument(std::string_view b) : bytes(b) {
+    if (b.size() < header_size || std::memcmp(b.data(), magic, 4) != 0) {
+        throw std::runtime_error("Not a binary document");
+    }
+    if (load32(b, 4) != version) throw std::runtime_error("Unsupported binary document version");
+    root_offset = load32(b, 8);
+    if (root_offset < header_size || root_offset >= b.size()) corrupt();
+}
+
+BinaryDocument BinaryDocument::open(const std::string& path) {
+    // Lookups jump around the file, so don't ask for readahead
+    auto file = std::make_shared<detail::MappedFile>(path, MADV_RANDOM);
+    BinaryDocument doc(std::string_view(file->data, file->size));
+    doc.mapping = std::move(file);
+    return doc;
+}
+
+BinaryValue BinaryDocument::root() const {
+    return BinaryValue(bytes, root_offset);
+}
+
+// BinaryArray
+
+BinaryArray::BinaryArray(std::string_view b, uint32_t off) : bytes(b), offset(off), count(load_count(b, off, 4)) {}
+
+BinaryValue BinaryArray::operator[](size_t index) const {
+    if (index >= count) throw std::out_of_range("Array index out of range");
+    return BinaryValue(bytes, child(bytes, offset, offset + 5 + 4 * index));
+}
+
+// BinaryObject
+
+BinaryObject::BinaryObject(std::string_view b, uint32_t off) : bytes(b), offset(off), count(load_count(b, off, 12)) {}
+
+std::string_view BinaryObject::key(size_t index) const {
+    if (index >= count) throw std::out_of_range("Object index out of range");
+    return load_string(bytes, child(bytes, offset, offset + 5 + 8 * index));
+}
+
+BinaryValue BinaryObject::value(size_t index) const {
+    if (index >= count) throw std::out_of_range("Object index out of range");
+    return BinaryValue(bytes, child(bytes, offset, offset + 9 + 8 * index));
+}
+
+std::optional<BinaryValue> BinaryObject::find(std::string_view k) const {
+    size_t sorted = offset + 5 + 8 * static_cast<size_t>(count);
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t i = load32(bytes, sorted + 4 * mid);
+        int c = key(i).compare(k);
+        if (c == 0) return value(i);
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return std::nullopt;
+}
+
+// BinaryValue
+
+BinaryValue::BinaryValue(std::string_view b, uint32_t off) : bytes(b), offset(off) {
+    if (off >= b.size()) corrupt();
+}
+
+uint8_t BinaryValue::tag() const {
+    return static_cast<uint8_t>(bytes[offset]);
+}
+
+bool BinaryValue::is_object() const { return tag() == t_object; }
+bool BinaryValue::is_array() const { return tag() == t_array; }
+bool BinaryValue::is_string() const { return tag() == t_string; }
+bool BinaryValue::is_number() const { return tag() == t_int || tag() == t_uint || tag() == t_double; }
+bool BinaryValue::is_int() const { return tag() == t_int || tag() == t_uint; }
+bool BinaryValue::is_bool() const { return tag() == t_true || tag() == t_false; }
+bool BinaryValue::is_null() const { return tag() == t_null; }
+
+namespace {
+
+void expect(bool ok, const char* what) {
+    if (!ok) throw std::runtime_error(std::string("BinaryValue is not ") + what);
+}
+
+} // namespace
+
+BinaryArray BinaryValue::as_array() const {
+    expect(is_array(), "an array");
+    return BinaryArray(bytes, offset);
+}
+
+BinaryObject BinaryValue::as_object() const {
+    expect(is_object(), "an object");
+    return BinaryObject(bytes, offset);
+}
+
+std::string_view BinaryValue::as_string() const {
+    expect(is_string(), "a string");
+    return load_string(bytes, offset);
+}
+
+double BinaryValue::as_number() const {
+    switch (tag()) {
+        case t_int: return static_cast<double>(static_cast<int64_t>(load64(bytes, offset + 1)));
+        case t_uint: return static_cast<double>(load64(bytes, offset + 1));
+        case t_double: return std::bit_cast<double>(load64(bytes, offset + 1));
+        default: expect(false, "a number"); return 0;
+    }
+}
+
+int64_t BinaryValue::as_int() const {
+    expect(is_int(), "an integer");
+    if (tag() == t_uint) throw std::out_of_range("Integer out of range");
+    return static_cast<int64_t>(load64(bytes, offset + 1));
+}
+
+uint64_t BinaryValue::as_uint() const {
+    expect(is_int(), "an integer");
+    uint64_t u = load64(bytes, offset + 1);
+    if (tag() == t_int && static_cast<int64_t>(u) < 0) throw std::out_of_range("Integer out of range");
+    return u;
+}
+
+bool BinaryValue::as_bool() const {
+    expect(is_bool(), "a bool");
+    return tag() == t_true;
+}
+
+size_t BinaryValue::size() const {
+    if (is_array()) return BinaryArray(bytes, offset).size();
+    expect(is_object(), "an array or object");
+    return BinaryObject(bytes, offset).size();
+}
+
+BinaryValue BinaryValue::operator[](std::string_view key) const {
+    if (auto v = find(key)) return *v;
+    throw std::out_of_range("Key not found: " + std::string(key));
+}
+
+BinaryValue BinaryValue::operator[](size_t index) const {
+    return as_array()[index];
+}
+
+std::optional<BinaryValue> BinaryValue::find(std::string_view key) const {
+    return as_object().find(key);
+}
+
+Value BinaryValue::to_value(size_t max_depth) const {
+    return decode(0, max_depth);
+}
+
+Value BinaryValue::decode(size_t depth, size_t max_depth) const {
+    uint8_t t = tag();
+    if ((t == t_array || t == t_object) && ++depth > max_depth) {
+        throw std::runtime_error("Nesting too deep at offset " + std::to_string(offset));
+    }
+    switch (t) {
+        case t_null: return nullptr;
+        case t_false: return false;
+        case t_true: return true;
+        case t_int: return as_int();
+        case t_uint: return load64(bytes, offset + 1);
+        case t_double: return as_number();
+        case t_string: return std::string(as_string());
+        case t_array: {
+            BinaryArray a(bytes, offset);
+            Array out;
+            out.reserve(a.size());
+            for (BinaryValue e : a) out.push_back(e.decode(depth, max_depth));
+            Value v;
+            v.data = std::move(out);
+            return v;
+        }
+        case t_object: {
+            BinaryObject o(bytes, offset);
+            Object out;
+            out.reserve(o.size());
+            for (size_t i = 0; i < o.size(); ++i) out.insert_or_assign(std::string(o.key(i)), o.value(i).decode(depth, max_depth));
+            Value v;
+            v.data = std::move(out);
+            return v;
+        }
+        default: corrupt();
+    }
+}
+
+} // namespace jsonn
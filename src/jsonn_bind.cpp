@@ -0,0 +1,193 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "jsonn_bind.h"
+#include "jsonn_parser.h"
+
+namespace jsonn {
+
+Reader::Reader(std::string_view json, const ParseOptions& options)
+    : in(json), validate_utf8(options.validate_utf8) {}
+
+void Reader::fail(const std::string& what) const {
+    throw std::runtime_error(what + " at position " + std::to_string(pos));
+}
+
+// Skips whitespace and returns the next character without consuming it
+char Reader::next() {
+    while (pos < in.size() && detail::is_ws(in[pos])) ++pos;
+    if (pos >= in.size()) fail("Unexpected end of input");
+    return in[pos];
+}
+
+char Reader::peek() {
+    char c = next();
+    return c == '-' || detail::is_digit(c) ? '0' : c;
+}
+
+bool Reader::read_null() {
+    if (next() != 'n') return false;
+    if (in.compare(pos, 4, "null") != 0) fail("Invalid literal");
+    pos += 4;
+    return true;
+}
+
+bool Reader::read_bool() {
+    char c = next();
+    if (c == 't' && in.compare(pos, 4, "true") == 0) { pos += 4; return true; }
+    if (c == 'f' && in.compare(pos, 5, "false") == 0) { pos += 5; return false; }
+    fail("Expected a bool");
+}
+
+int64_t Reader::read_int() {
+    char c = next();
+    if (c != '-' && !detail::is_digit(c)) fail("Expected an integer");
+    detail::Number n;
+    size_t start = pos;
+    pos = detail::scan_number(in.data(), in.size(), pos, n);
+    if (n.kind != detail::Number::integer) {
+        pos = start;
+        fail(n.kind == detail::Number::floating ? "Expected an integer" : "Integer out of range");
+    }
+    return n.i;
+}
+
+uint64_t Reader::read_uint() {
+    char c = next();
+    if (!detail::is_digit(c)) fail("Expected an unsigned integer");
+    detail::Number n;
+    size_t start = pos;
+    pos = detail::scan_number(in.data(), in.size(), pos, n);
+    if (n.kind == detail::Number::integer) return static_cast<uint64_t>(n.i);
+    if (n.kind == detail::Number::unsigned_integer) return n.u;
+    pos = start;
+    fail("Expected an unsigned integer");
+}
+
+double Reader::read_double() {
+    char c = next();
+    if (c != '-' && !detail::is_digit(c)) fail("Expected a number");
+    detail::Number n;
+    pos = detail::scan_number(in.data(), in.size(), pos, n);
+    switch (n.kind) {
+        case detail::Number::integer: return static_cast<double>(n.i);
+        case detail::Number::unsigned_integer: return static_cast<double>(n.u);
+        default: return n.d;
+    }
+}
+
+std::string_view Reader::read_string() {
+    if (next() != '"') fail("Expected a string");
+    std::string_view s;
+    pos = detail::scan_string(in.data(), in.size(), pos + 1, s, scratch, validate_utf8);
+    return s;
+}
+
+// Skips the value to find where it ends, then parses just that slice
+Value Reader::read_value() {
+    size_t start = (next(), pos);
+    skip();
+    ParseOptions options;
+    options.validate_utf8 = validate_utf8;
+    return parse(in.substr(start, pos - start), options);
+}
+
+void Reader::skip() {
+    switch (next()) {
+        case '{': {
+            std::string_view key;
+            begin_object();
+            while (next_key(key)) skip();
+            return;
+        }
+        case '[':
+            begin_array();
+            while (next_element()) skip();
+            return;
+        case '"': read_string(); return;
+        case 't': case 'f': read_bool(); return;
+        case 'n': if (!read_null()) fail("Invalid literal"); return;
+        default: read_double(); return;
+    }
+}
+
+void Reader::begin_object() {
+    if (next() != '{') fail("Expected an object");
+    ++pos;
+    first = true;
+}
+
+bool Reader::next_key(std::string_view& key) {
+    char c = next();
+    if (c == '}') {
+        ++pos;
+        first = false;
+        return false;
+    }
+    if (!first) {
+        if (c != ',') fail("Expected ',' in object");
+        ++pos;
+    }
+    first = false;
+    key = read_string();
+    if (next() != ':') fail("Expected ':' after key");
+    ++pos;
+    return true;
+}
+
+void Reader::begin_array() {
+    if (next() != '[') fail("Expected an array");
+    ++pos;
+    first = true;
+}
+
+bool Reader::next_element() {
+    char c = next();
+    if (c == ']') {
+        ++pos;
+        first = false;
+        return false;
+    }
+    if (!first) {
+        if (c != ',') fail("Expected ',' in array");
+        ++pos;
+    }
+    first = false;
+    return true;
+}
+
+void Reader::finish() {
+    while (pos < in.size() && detail::is_ws(in[pos])) ++pos;
+    if (pos != in.size()) fail("Extra data after JSON");
+}
+
+} // namespace jsonn
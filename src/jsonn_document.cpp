@@ -0,0 +1,256 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include "jsonn_parser.h"
+#include "jsonn_simd.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace jsonn {
+
+// Arena
+
+Arena::~Arena() {
+    release();
+}
+
+void Arena::release() {
+    while (blocks) {
+        Block* next = blocks->next;
+        ::operator delete(blocks);
+        blocks = next;
+    }
+    total = 0;
+    cur = end = nullptr;
+}
+
+void Arena::add_block(size_t size) {
+    Block* b = static_cast<Block*>(::operator new(sizeof(Block) + size));
+    b->next = blocks;
+    b->size = size;
+    blocks = b;
+    cur = reinterpret_cast<char*>(b + 1);
+    end = cur + size;
+    total += size;
+}
+
+void* Arena::allocate_slow(size_t size, size_t align) {
+    // Grow geometrically so a large document needs few blocks
+    add_block(std::max({block_size, total, size + align}));
+    return allocate(size, align);
+}
+
+void Arena::reset() {
+    if (!blocks) return;
+    if (blocks->next) {
+        size_t merged = total;
+        release();
+        add_block(merged);
+        return;
+    }
+    cur = reinterpret_cast<char*>(blocks + 1);
+    end = cur + blocks->size;
+}
+
+namespace {
+
+using detail::Member;
+using detail::Node;
+using detail::NodeType;
+
+// Builds arena nodes. Children are collected on the Document's stacks and
+// copied into the arena in one piece when their container closes.
+struct ArenaBuilder {
+    using value_type = Node;
+    using array_frame = size_t;
+    struct object_frame {
+        size_t mark;
+        const char* key;
+        uint32_t key_size;
+    };
+
+    Arena& arena;
+    std::vector<Node>& nodes;
+    std::vector<Member>& members;
+    std::string_view input = {}; // set when strings may point into it
+
+    static Node make(NodeType type, uint32_t size = 0) {
+        Node n;
+        n.type = type;
+        n.size = size;
+        n.s = nullptr;
+        return n;
+    }
+
+    const char* copy(std::string_view s) {
+        if (s.size() > UINT32_MAX) throw std::runtime_error("String too long for Document");
+        // Unescaped strings come back from the parser as views of the input
+        if (s.data() >= input.data() && s.data() + s.size() <= input.data() + input.size()) return s.data();
+        char* p = static_cast<char*>(arena.allocate(s.size(), 1));
+        std::memcpy(p, s.data(), s.size());
+        return p;
+    }
+
+    Node make_null() { return make(NodeType::null); }
+    Node make_bool(bool b) { Node n = make(NodeType::boolean); n.b = b; return n; }
+    Node make_int(int64_t i) { Node n = make(NodeType::integer); n.i = i; return n; }
+    Node make_uint(uint64_t u) { Node n = make(NodeType::unsigned_integer); n.u = u; return n; }
+    Node make_double(double d) { Node n = make(NodeType::floating); n.d = d; return n; }
+    Node make_string(std::string_view s) {
+        Node n = make(NodeType::string, static_cast<uint32_t>(s.size()));
+        n.s = copy(s);
+        return n;
+    }
+
+    size_t begin_array() { return nodes.size(); }
+    void push(size_t&, Node&& n) { nodes.push_back(n); }
+    Node end_array(size_t& mark) {
+        size_t count = nodes.size() - mark;
+        Node n = make(NodeType::array, static_cast<uint32_t>(count));
+        if (count) {
+            Node* dst = static_cast<Node*>(arena.allocate(count * sizeof(Node), alignof(Node)));
+            std::memcpy(dst, nodes.data() + mark, count * sizeof(Node));
+            n.elements = dst;
+        }
+        nodes.resize(mark);
+        return n;
+    }
+
+    object_frame begin_object() { return {members.size(), nullptr, 0}; }
+    void key(object_frame& f, std::string_view k) {
+        f.key = copy(k);
+        f.key_size = static_cast<uint32_t>(k.size());
+    }
+    void member(object_frame& f, Node&& v) { members.push_back(Member{f.key, f.key_size, v}); }
+    Node end_object(object_frame& f) {
+        size_t count = members.size() - f.mark;
+        Node n = make(NodeType::object, static_cast<uint32_t>(count));
+        if (count) {
+            Member* dst = static_cast<Member*>(arena.allocate(count * sizeof(Member), alignof(Member)));
+            std::memcpy(dst, members.data() + f.mark, count * sizeof(Member));
+            n.members = dst;
+        }
+        members.resize(f.mark);
+        return n;
+    }
+};
+
+} // namespace
+
+// Document
+
+Element Document::parse(std::string_view json, const ParseOptions& options) {
+    JSONN_STATS_SCOPE("Document::parse", parse);
+    JSONN_STAT(st->bytes_parsed += json.size());
+    root_node = nullptr;
+    arena.reset();
+#if JSONN_STATS
+    size_t reserved = arena.capacity();
+#endif
+    node_stack.clear();
+    member_stack.clear();
+
+    ArenaBuilder builder{arena, node_stack, member_stack};
+    if (options.borrow_strings) builder.input = json;
+    Node root;
+    if (options.mode == ParseMode::indexed && json.size() <= UINT32_MAX) {
+        index.clear();
+        detail::build_structural_index(json.data(), json.size(), index);
+        detail::Parser<true, ArenaBuilder> p(builder, json.data(), json.size(), index);
+        p.validate_utf8 = options.validate_utf8;
+        p.max_depth = options.max_depth;
+        root = p.parse_document();
+    } else {
+        detail::Parser<false, ArenaBuilder> p(builder, json.data(), json.size());
+        p.validate_utf8 = options.validate_utf8;
+        p.max_depth = options.max_depth;
+        root = p.parse_document();
+    }
+
+    Node* stored = static_cast<Node*>(arena.allocate(sizeof(Node), alignof(Node)));
+    *stored = root;
+    root_node = stored;
+    JSONN_STAT(if (arena.capacity() > reserved) { ++st->allocations; st->allocated_bytes += arena.capacity() - reserved; });
+    return Element(root_node);
+}
+
+Element Document::root() const {
+    if (!root_node) throw std::runtime_error("Document is empty");
+    return Element(root_node);
+}
+
+// Element
+
+std::optional<Element> Element::find(std::string_view key) const {
+    expect(is_object(), "an object");
+    // Search backwards so the last of duplicate keys wins, as in Value
+    for (size_t i = node->size; i-- > 0;) {
+        const Member& m = node->members[i];
+        if (m.key_size == key.size() && std::memcmp(m.key, key.data(), key.size()) == 0) {
+            return Element(&m.value);
+        }
+    }
+    return std::nullopt;
+}
+
+Element Element::operator[](std::string_view key) const {
+    if (auto e = find(key)) return *e;
+    throw std::out_of_range("Key not found: " + std::string(key));
+}
+
+Value Element::to_value() const {
+    switch (node->type) {
+        case NodeType::null: return nullptr;
+        case NodeType::boolean: return node->b;
+        case NodeType::integer: return node->i;
+        case NodeType::unsigned_integer: return node->u;
+        case NodeType::floating: return node->d;
+        case NodeType::string: return std::string(node->s, node->size);
+        case NodeType::array: {
+            Value v;
+            Array& arr = v.data.emplace<Array>();
+            arr.reserve(node->size);
+            for (Element e : as_array()) arr.push_back(e.to_value());
+            return v;
+        }
+        case NodeType::object: {
+            Value v;
+            Object& obj = v.data.emplace<Object>();
+            for (auto [key, e] : as_object()) obj.insert_or_assign(std::string(key), e.to_value());
+            return v;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace jsonn
@@ -0,0 +1,106 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+#include "jsonn.h"
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// Line splitting and bad-line bookkeeping shared by the JSONL parsers
+
+namespace jsonn::detail {
+
+// Calls fn(line, number) for every non-empty line of text, with a trailing
+// '\r' stripped and number the line's 0-based index in text, empty lines
+// included. Stops when fn returns false. Returns how many lines it went
+// through.
+template <class F>
+size_t for_each_line(std::string_view text, F&& fn) {
+    size_t pos = 0;
+    size_t number = 0;
+    while (pos < text.size()) {
+        size_t stop = text.find('\n', pos);
+        if (stop == std::string_view::npos) stop = text.size();
+        std::string_view line = text.substr(pos, stop - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty() && !fn(line, number)) break;
+        ++number;
+        pos = stop + 1;
+    }
+    return number;
+}
+
+// Bad lines of a parallel JSONL parse. Each task parses its chunk through
+// parse_chunk(), which records errors with chunk-relative line numbers and,
+// unless options.skip_errors, stops at the first. finish() numbers them for
+// the whole input, which is only possible once every chunk before has been
+// counted, then throws the first or hands them all to options.on_error.
+class JsonlErrors {
+public:
+    JsonlErrors(std::string_view jsonl, const ParallelOptions& options) : input(jsonl), options(options) {}
+
+    void resize(size_t chunks) {
+        errors.resize(chunks);
+        lines.resize(chunks);
+    }
+
+    // Calls parse_line(line) for each line of chunk i
+    template <class F>
+    void parse_chunk(size_t i, std::string_view chunk, F&& parse_line) {
+        lines[i] = for_each_line(chunk, [&](std::string_view line, size_t number) {
+            try {
+                parse_line(line);
+            } catch (const std::exception& e) {
+                errors[i].push_back({number, static_cast<size_t>(line.data() - input.data()), line, e.what()});
+                return options.skip_errors;
+            }
+            return true;
+        });
+    }
+
+    void finish();
+
+private:
+    std::string_view input;
+    const ParallelOptions& options;
+    std::vector<std::vector<JsonlError>> errors;
+    std::vector<size_t> lines;
+};
+
+// Cuts jsonl into line-aligned chunks, calls count with how many there are,
+// then runs task(i, chunk) for each, in parallel unless the input is below
+// options.serial_threshold. Rethrows the error of the earliest failing chunk.
+void run_jsonl_chunks(std::string_view jsonl, const ParallelOptions& options, const std::function<void(size_t)>& count,
+                      const std::function<void(size_t, std::string_view)>& task);
+
+} // namespace jsonn::detail
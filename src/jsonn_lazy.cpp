@@ -0,0 +1,301 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include "jsonn_parser.h"
+#include "jsonn_simd.h"
+#include <cstring>
+
+namespace jsonn {
+
+using detail::is_ws;
+
+// LazyDocument
+
+LazyValue LazyDocument::parse(std::string_view json) {
+    input = {};
+    if (json.size() > UINT32_MAX) throw std::runtime_error("Input too large for LazyDocument");
+    index.clear();
+    detail::build_structural_index(json.data(), json.size(), index);
+    jump.resize(index.size());
+    input = json;
+    try {
+        validate();
+    } catch (...) {
+        input = {};
+        throw;
+    }
+    return LazyValue(this, 0);
+}
+
+LazyValue LazyDocument::root() const {
+    if (input.empty()) throw std::runtime_error("LazyDocument is empty");
+    return LazyValue(this, 0);
+}
+
+// Walks the tokens once to check the grammar and match brackets. Scalars
+// are only checked to start with a character a value can start with.
+void LazyDocument::validate() {
+    enum class State { value, first_value, key, first_key, colon, after_value };
+    const char* str = input.data();
+    State state = State::value;
+    open.clear();
+
+    auto fail = [&](const char* what, size_t pos) {
+        throw std::runtime_error(std::string(what) + " at position " + std::to_string(pos));
+    };
+
+    uint32_t tokens = static_cast<uint32_t>(index.size());
+    for (uint32_t t = 0; t < tokens; ++t) {
+        size_t pos = index[t];
+        char c = str[pos];
+
+        bool close = false;
+        switch (state) {
+            case State::first_value:
+                if (c == ']') { close = true; break; }
+                [[fallthrough]];
+            case State::value:
+                if (c == '{' || c == '[') {
+                    open.push_back(t);
+                    state = c == '{' ? State::first_key : State::first_value;
+                } else if (c == '"' || c == '-' || detail::is_digit(c) || c == 't' || c == 'f' || c == 'n') {
+                    state = State::after_value;
+                } else {
+                    fail(("Unexpected character: " + std::string(1, c)).c_str(), pos);
+                }
+                break;
+            case State::first_key:
+                if (c == '}') { close = true; break; }
+                [[fallthrough]];
+            case State::key:
+                if (c != '"') fail("Expected string key", pos);
+                state = State::colon;
+                break;
+            case State::colon:
+                if (c != ':') fail("Expected ':' after key", pos);
+                state = State::value;
+                break;
+            case State::after_value: {
+                if (open.empty()) fail("Extra data after JSON", pos);
+                bool in_object = str[index[open.back()]] == '{';
+                if (c == ',') {
+                    state = in_object ? State::key : State::value;
+                } else if (c == (in_object ? '}' : ']')) {
+                    close = true;
+                } else {
+                    fail(in_object ? "Expected ',' in object" : "Expected ',' in array", pos);
+                }
+                break;
+            }
+        }
+
+        if (close) {
+            jump[open.back()] = t + 1;
+            open.pop_back();
+            state = State::after_value;
+        }
+    }
+
+    if (state != State::after_value || !open.empty()) fail("Unexpected end of input", input.size());
+}
+
+size_t LazyDocument::scalar_end(uint32_t t) const {
+    size_t begin = index[t];
+    size_t end = position(t + 1);
+    while (end > begin && is_ws(input[end - 1])) --end;
+    return end;
+}
+
+// LazyValue
+
+char LazyValue::first() const {
+    return doc->input[doc->index[token]];
+}
+
+std::string LazyValue::as_string() const {
+    expect(is_string(), "a string");
+    std::string out;
+    detail::decode_string(doc->input.data(), doc->input.size(), doc->index[token] + 1, out);
+    return out;
+}
+
+detail::Number LazyValue::number() const {
+    expect(is_number(), "a number");
+    size_t end = doc->scalar_end(token);
+    detail::Number n;
+    size_t pos = detail::scan_number(doc->input.data(), end, doc->index[token], n);
+    if (pos != end) {
+        throw std::runtime_error("Unexpected character: " + std::string(1, doc->input[pos]) + " at position " + std::to_string(pos));
+    }
+    return n;
+}
+
+bool LazyValue::is_int() const {
+    return is_number() && number().kind != detail::Number::floating;
+}
+
+double LazyValue::as_number() const {
+    detail::Number n = number();
+    switch (n.kind) {
+        case detail::Number::integer: return static_cast<double>(n.i);
+        case detail::Number::unsigned_integer: return static_cast<double>(n.u);
+        default: return n.d;
+    }
+}
+
+int64_t LazyValue::as_int() const {
+    detail::Number n = number();
+    expect(n.kind != detail::Number::floating, "an integer");
+    if (n.kind == detail::Number::unsigned_integer) throw std::out_of_range("Integer out of range");
+    return n.i;
+}
+
+uint64_t LazyValue::as_uint() const {
+    detail::Number n = number();
+    expect(n.kind != detail::Number::floating, "an integer");
+    if (n.kind == detail::Number::unsigned_integer) return n.u;
+    if (n.i < 0) throw std::out_of_range("Integer out of range");
+    return static_cast<uint64_t>(n.i);
+}
+
+bool LazyValue::as_bool() const {
+    expect(is_bool(), "a bool");
+    std::string_view text = raw();
+    if (text == "true") return true;
+    if (text == "false") return false;
+    throw std::runtime_error("Invalid literal at position " + std::to_string(doc->index[token]));
+}
+
+std::string_view LazyValue::raw() const {
+    size_t begin = doc->index[token];
+    char c = first();
+    if (c == '{' || c == '[') {
+        // The closing bracket is the token before the jump target
+        return doc->input.substr(begin, doc->index[doc->jump[token] - 1] + 1 - begin);
+    }
+    return doc->input.substr(begin, doc->scalar_end(token) - begin);
+}
+
+size_t LazyValue::size() const {
+    size_t n = 0;
+    if (is_array()) {
+        for (auto it = as_array().begin(), end = as_array().end(); it != end; ++it) ++n;
+    } else {
+        for (auto it = as_object().begin(), end = as_object().end(); it != end; ++it) ++n;
+    }
+    return n;
+}
+
+std::optional<LazyValue> LazyValue::find(std::string_view key) const {
+    expect(is_object(), "an object");
+    const std::string_view in = doc->input;
+    std::optional<LazyValue> found;
+    std::string decoded;
+    uint32_t close = doc->jump[token] - 1;
+    uint32_t t = token + 1;
+    while (t != close) {
+        // Raw key text sits between the quotes before the ':' token. Only
+        // keys with escapes need decoding to compare. Every match is taken
+        // so the last of duplicate keys wins, as in Value.
+        size_t begin = doc->index[t] + 1;
+        std::string_view name = in.substr(begin, doc->scalar_end(t) - 1 - begin);
+        bool match;
+        if (name.find('\\') == std::string_view::npos) {
+            match = name == key;
+        } else {
+            decoded.clear();
+            detail::decode_string(in.data(), in.size(), begin, decoded);
+            match = decoded == key;
+        }
+        if (match) found = LazyValue(doc, t + 2);
+        t = doc->skip(t + 2);
+        if (in[doc->index[t]] == ',') ++t;
+    }
+    return found;
+}
+
+LazyValue LazyValue::operator[](std::string_view key) const {
+    if (auto v = find(key)) return *v;
+    throw std::out_of_range("Key not found: " + std::string(key));
+}
+
+LazyValue LazyValue::operator[](size_t index) const {
+    LazyArray arr = as_array();
+    for (auto it = arr.begin(), end = arr.end(); it != end; ++it) {
+        if (index-- == 0) return *it;
+    }
+    throw std::out_of_range("Array index out of range");
+}
+
+Value LazyValue::to_value() const {
+    detail::ValueBuilder builder;
+    detail::Parser<true, detail::ValueBuilder> p(builder, doc->input.data(), doc->input.size(), doc->index, token);
+    return p.parse_value();
+}
+
+// LazyArray, LazyObject
+
+LazyArray::iterator LazyArray::begin() const {
+    return iterator(doc, token + 1);
+}
+
+LazyArray::iterator LazyArray::end() const {
+    return iterator(doc, doc->jump[token] - 1);
+}
+
+LazyArray::iterator& LazyArray::iterator::operator++() {
+    token = doc->skip(token);
+    if (doc->input[doc->index[token]] == ',') ++token;
+    return *this;
+}
+
+LazyObject::iterator LazyObject::begin() const {
+    return iterator(doc, token + 1);
+}
+
+LazyObject::iterator LazyObject::end() const {
+    return iterator(doc, doc->jump[token] - 1);
+}
+
+std::pair<std::string, LazyValue> LazyObject::iterator::operator*() const {
+    std::string key;
+    detail::decode_string(doc->input.data(), doc->input.size(), doc->index[token] + 1, key);
+    return {std::move(key), LazyValue(doc, token + 2)};
+}
+
+LazyObject::iterator& LazyObject::iterator::operator++() {
+    token = doc->skip(token + 2);
+    if (doc->input[doc->index[token]] == ',') ++token;
+    return *this;
+}
+
+} // namespace jsonn
@@ -0,0 +1,198 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#include <bit>
+#include <charconv>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
+// libc++ only has std::from_chars for double from LLVM 20 on
+#ifndef JSONN_FROM_CHARS_DOUBLE
+#if defined(_LIBCPP_VERSION) && _LIBCPP_VERSION < 200000
+#define JSONN_FROM_CHARS_DOUBLE 0
+#else
+#define JSONN_FROM_CHARS_DOUBLE 1
+#endif
+#endif
+
+namespace jsonn::detail {
+
+struct Number {
+    enum Kind : uint8_t { integer, unsigned_integer, floating };
+    Kind kind = integer;
+    int64_t i = 0;  // integer
+    uint64_t u = 0; // unsigned_integer, only used above INT64_MAX
+    double d = 0;   // floating
+};
+
+// True when all eight bytes at p are ASCII digits
+inline bool is_eight_digits(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return ((v & 0xF0F0F0F0F0F0F0F0) == 0x3030303030303030) &&
+           (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) == 0x3030303030303030);
+}
+
+// Value of eight ASCII digits, combined pairwise in one register (SWAR)
+inline uint32_t parse_eight_digits(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    if constexpr (std::endian::native != std::endian::little) v = __builtin_bswap64(v);
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<uint32_t>(v);
+}
+
+// Accumulates a run of digits into m, eight at a time while possible.
+// Returns the position after the run; m wraps once the run passes 19
+// digits, callers check the count.
+inline size_t scan_digits(const char* str, size_t len, size_t pos, uint64_t& m) {
+    while (len - pos >= 8 && is_eight_digits(str + pos)) {
+        m = m * 100000000 + parse_eight_digits(str + pos);
+        pos += 8;
+    }
+    while (pos < len && static_cast<unsigned char>(str[pos] - '0') < 10) {
+        m = m * 10 + static_cast<unsigned char>(str[pos] - '0');
+        ++pos;
+    }
+    return pos;
+}
+
+// Correctly rounded conversion of text already checked to be a JSON
+// number. Results below the smallest double come out as the nearest
+// subnormal or zero; returns false if the number is too large for a double.
+inline bool convert_double(const char* first, const char* last, double& out) {
+#if JSONN_FROM_CHARS_DOUBLE
+    auto res = std::from_chars(first, last, out);
+    if (res.ec == std::errc()) return true;
+#endif
+    // from_chars reports underflow as a range error without a value, and
+    // may be missing altogether; strtod in the C locale gives both
+    static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", nullptr);
+    std::string text(first, last);
+    out = strtod_l(text.c_str(), nullptr, c_locale);
+    return !std::isinf(out);
+}
+
+// Scans and converts the number starting at pos, returns the position after
+// it. Integers that fit become int64 (or uint64 above INT64_MAX), larger
+// ones are read as doubles. Doubles whose digits fit in 53 bits with a
+// small exponent are exact after one multiply or divide; the rest go
+// through convert_double. Doubles too large to represent are an error
+// rather than infinity, which JSON can't write back.
+inline size_t scan_number(const char* str, size_t len, size_t pos, Number& out, size_t base = 0) {
+    static constexpr double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    size_t start = pos;
+    bool negative = pos < len && str[pos] == '-';
+    if (negative) ++pos;
+
+    uint64_t m = 0;
+    size_t int_start = pos;
+    pos = scan_digits(str, len, pos, m);
+    size_t digits = pos - int_start;
+    bool ok = digits > 0 && !(str[int_start] == '0' && digits > 1);
+    bool is_double = false;
+    int64_t exponent = 0;
+
+    if (pos < len && str[pos] == '.') {
+        is_double = true;
+        size_t frac = ++pos;
+        pos = scan_digits(str, len, pos, m);
+        ok = ok && pos > frac;
+        digits += pos - frac;
+        exponent = -static_cast<int64_t>(pos - frac);
+    }
+    if (pos < len && (str[pos] == 'e' || str[pos] == 'E')) {
+        is_double = true;
+        ++pos;
+        bool exp_negative = pos < len && str[pos] == '-';
+        if (pos < len && (str[pos] == '+' || str[pos] == '-')) ++pos;
+        size_t exp_start = pos;
+        int64_t e = 0;
+        for (; pos < len && static_cast<unsigned char>(str[pos] - '0') < 10; ++pos) {
+            if (e < 100000) e = e * 10 + (str[pos] - '0');
+        }
+        ok = ok && pos > exp_start;
+        exponent += exp_negative ? -e : e;
+    }
+
+    const char* first = str + start;
+    const char* last = str + pos;
+    if (!ok) throw std::runtime_error("Invalid number: " + std::string(first, last) + " at position " + std::to_string(base + start));
+
+    if (!is_double && digits <= 19) {
+        if (!negative && m <= INT64_MAX) {
+            out.kind = Number::integer;
+            out.i = static_cast<int64_t>(m);
+            return pos;
+        }
+        if (!negative) {
+            out.kind = Number::unsigned_integer;
+            out.u = m;
+            return pos;
+        }
+        if (m <= uint64_t(INT64_MAX) + 1) {
+            out.kind = Number::integer;
+            out.i = static_cast<int64_t>(0 - m);
+            return pos;
+        }
+    } else if (!is_double && !negative && digits == 20) {
+        auto res = std::from_chars(str + int_start, last, out.u);
+        if (res.ec == std::errc()) {
+            out.kind = Number::unsigned_integer;
+            return pos;
+        }
+    }
+
+    out.kind = Number::floating;
+    if (digits <= 19 && m <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double d = static_cast<double>(m);
+        d = exponent < 0 ? d / pow10[-exponent] : d * pow10[exponent];
+        out.d = negative ? -d : d;
+        return pos;
+    }
+    if (convert_double(first, last, out.d)) return pos;
+    throw std::runtime_error("Number out of range: " + std::string(first, last) + " at position " + std::to_string(base + start));
+}
+
+} // namespace jsonn::detail
@@ -0,0 +1,215 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include <functional>
+
+namespace jsonn {
+
+namespace {
+
+size_t hash_key(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+}
+
+} // namespace
+
+Object::Object(std::initializer_list<std::pair<const std::string, Value>> init) {
+    reserve(init.size());
+    for (const auto& kv : init) (*this)[kv.first] = kv.second;
+}
+
+void Object::reserve(size_t n) {
+    own_keys().names.reserve(n);
+    values.reserve(n);
+}
+
+void Object::clear() {
+    keys.reset();
+    values.clear();
+}
+
+size_t Object::erase(std::string_view key) {
+    ptrdiff_t i = index_of(key);
+    if (i < 0) return 0;
+    Keys& k = own_keys();
+    k.names.erase(k.names.begin() + i);
+    values.erase(values.begin() + i);
+    rebuild_index();
+    return 1;
+}
+
+std::optional<Value> Object::extract(std::string_view key) {
+    ptrdiff_t i = index_of(key);
+    if (i < 0) return std::nullopt;
+    std::optional<Value> v(std::move(values[i]));
+    Keys& k = own_keys();
+    k.names.erase(k.names.begin() + i);
+    values.erase(values.begin() + i);
+    rebuild_index();
+    return v;
+}
+
+// Same keys with equal values, in any order
+bool Object::operator==(const Object& other) const {
+    if (size() != other.size()) return false;
+    if (keys == other.keys) return values == other.values;
+    for (size_t i = 0; i < values.size(); ++i) {
+        ptrdiff_t j = other.index_of(keys->names[i]);
+        if (j < 0 || !(values[i] == other.values[j])) return false;
+    }
+    return true;
+}
+
+ptrdiff_t Object::hashed_index_of(std::string_view key) const {
+    const std::vector<uint32_t>& slots = keys->slots;
+    size_t mask = slots.size() - 1;
+    for (size_t h = hash_key(key) & mask; slots[h]; h = (h + 1) & mask) {
+        size_t i = slots[h] - 1;
+        if (keys->names[i] == key) return static_cast<ptrdiff_t>(i);
+    }
+    return -1;
+}
+
+// Copy on write: a key list shared with other objects is cloned before it
+// is changed
+Object::Keys& Object::own_keys() {
+    if (!keys) {
+        keys = std::make_shared<Keys>();
+    } else if (keys.use_count() > 1) {
+        keys = std::make_shared<Keys>(*keys);
+    }
+    return *keys;
+}
+
+// Adds the last key to the hash index, growing it to stay at most half full
+void Object::index_last() {
+    Keys& k = *keys;
+    if (k.slots.size() < 2 * k.names.size()) {
+        rebuild_index();
+        return;
+    }
+    size_t mask = k.slots.size() - 1;
+    size_t h = hash_key(k.names.back()) & mask;
+    while (k.slots[h]) h = (h + 1) & mask;
+    k.slots[h] = static_cast<uint32_t>(k.names.size());
+}
+
+void Object::rebuild_index() {
+    Keys& k = *keys;
+    k.slots.clear();
+    if (k.names.size() < hash_threshold) return;
+
+    size_t capacity = 32;
+    while (capacity < 4 * k.names.size()) capacity *= 2;
+    k.slots.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < k.names.size(); ++i) {
+        size_t h = hash_key(k.names[i]) & mask;
+        while (k.slots[h]) h = (h + 1) & mask;
+        k.slots[h] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+// KeyTable
+
+// A node in the trie of key sequences. Its key list is only built once an
+// object actually ends on it.
+struct KeyTable::Shape {
+    struct Edge {
+        std::string key;
+        Shape* next;
+        uint32_t slot;
+    };
+
+    Shape* parent = nullptr;
+    std::string key;
+    uint32_t depth = 0;
+    std::vector<Edge> edges;
+    std::shared_ptr<Object::Keys> keys;
+};
+
+KeyTable::KeyTable(size_t max_shapes, size_t max_keys) : max_shapes(max_shapes), max_keys(max_keys) {
+    clear();
+}
+
+KeyTable::~KeyTable() = default;
+
+void KeyTable::clear() {
+    shapes.clear();
+    shapes.push_back(std::make_unique<Shape>());
+}
+
+KeyTable::Shape* KeyTable::step(Shape* shape, std::string_view key, uint32_t& slot) {
+    for (const Shape::Edge& e : shape->edges) {
+        if (e.key == key) {
+            slot = e.slot;
+            return e.next;
+        }
+    }
+    // Past this many branches the keys look like data rather than a schema
+    if (shape->edges.size() >= 32 || shapes.size() > max_shapes) return nullptr;
+
+    // A repeated key keeps the shape and overwrites the earlier value, as
+    // insert_or_assign does
+    uint32_t depth = shape->depth;
+    for (Shape* s = shape; s->parent; s = s->parent) {
+        if (s->key == key) {
+            shape->edges.push_back(Shape::Edge{std::string(key), shape, s->depth - 1});
+            slot = s->depth - 1;
+            return shape;
+        }
+    }
+    if (depth >= max_keys) return nullptr;
+
+    auto next = std::make_unique<Shape>();
+    next->parent = shape;
+    next->key.assign(key);
+    next->depth = depth + 1;
+    shape->edges.push_back(Shape::Edge{next->key, next.get(), depth});
+    shapes.push_back(std::move(next));
+    slot = depth;
+    return shapes.back().get();
+}
+
+void KeyTable::attach(Object& obj, Shape* shape) {
+    if (!shape->keys) {
+        Object tmp;
+        Object::Keys& k = tmp.own_keys();
+        k.names.resize(shape->depth);
+        for (Shape* s = shape; s->parent; s = s->parent) k.names[s->depth - 1] = s->key;
+        tmp.rebuild_index();
+        shape->keys = std::move(tmp.keys);
+    }
+    obj.keys = shape->keys;
+}
+
+} // namespace jsonn
@@ -30,168 +30,52 @@
 */
 
 #include "jsonn.h"
+#include "jsonn_parser.h"
+#include "jsonn_simd.h"
+#include "jsonn_mmap.h"
 #include <stdexcept>
-#include <sstream>
-namespace jsonn {
-class Parser {
-    const std::string& str;
-    size_t pos;
-
-public:
-    Parser(const std::string& s) : str(s), pos(0) {}
-
-    void skip_whitespace() {
-        while (pos < str.size() && std::isspace(str[pos])) ++pos;
-    }
-
-    size_t get_pos() { return pos; } 
-
-    char peek() {
-        skip_whitespace();
-        if (pos >= str.size()) throw std::runtime_error("Unexpected end of input at position " + std::to_string(pos));
-        return str[pos];
-    }
-
-    char get() {
-        skip_whitespace();
-        if (pos >= str.size()) throw std::runtime_error("Unexpected end of input at position " + std::to_string(pos));
-        return str[pos++];
-    }
-
-    Value parse_value() {
-        char c = peek();
-        if (c == '{') return parse_object();
-        if (c == '[') return parse_array();
-        if (c == '"') return parse_string();
-        if (std::isdigit(c) || c == '-') return parse_number();
-        if (c == 't') return parse_true();
-        if (c == 'f') return parse_false();
-        if (c == 'n') return parse_null();
-        throw std::runtime_error("Unexpected character: " + std::string(1, c) + " at position " + std::to_string(pos));
-    }
-
-private:
-    Value parse_object() {
-        get(); // consume '{'
-        Object obj;
-        skip_whitespace();
-        if (peek() == '}') { get(); return obj; }
-
-        while (true) {
-            std::string key = parse_string();
-            if (get() != ':') throw std::runtime_error("Expected ':' after key at position " + std::to_string(pos));
-            Value val = parse_value();
-            obj[key] = val;
-
-            char c = get();
-            if (c == '}') break;
-            if (c != ',') throw std::runtime_error("Expected ',' in object at position " + std::to_string(pos));
-        }
-        return obj;
-    }
-
-    Value parse_array() {
-        get(); // consume '['
-        Array arr;
-        skip_whitespace();
-        if (peek() == ']') { get(); return arr; }
-
-        while (true) {
-            arr.push_back(parse_value());
-            char c = get();
-            if (c == ']') break;
-            if (c != ',') throw std::runtime_error("Expected ',' in array at position " + std::to_string(pos));
-        }
-        return arr;
-    }
 
-    std::string parse_string() {
-        get(); // consume '"'
-        std::ostringstream oss;
-        while (true) {
-            if (pos >= str.size()) throw std::runtime_error("Unterminated string at position " + std::to_string(pos));
-            char c = str[pos++];
-            if (c == '"') break;
-            if (c == '\\') {
-                if (pos >= str.size()) throw std::runtime_error("Unterminated escape sequence at position " + std::to_string(pos));
-                char esc = str[pos++];
-                switch (esc) {
-                    case 'n': oss << '\n'; break;
-                    case 't': oss << '\t'; break;
-                    case 'r': oss << '\r'; break;
-                    case 'b': oss << '\b'; break;
-                    case 'f': oss << '\f'; break;
-                    case '"': oss << '"'; break;
-                    case '\\': oss << '\\'; break;
-                    case 'u': { // Unicode escape
-                        if (pos + 4 > str.size()) throw std::runtime_error("Invalid unicode escape at position " + std::to_string(pos));
-                        std::string hex = str.substr(pos, 4);
-                        pos += 4;
-                        char16_t code = static_cast<char16_t>(std::stoi(hex, nullptr, 16));
-                        oss << static_cast<char>(code); // Simple conversion, nie obsługuje surrogate pairs
-                        break;
-                    }
-                    default:
-                        throw std::runtime_error("Unknown escape character: \\" + std::string(1, esc) + " at position " + std::to_string(pos));
-                }
-            } else {
-                oss << c;
-            }
-        }
-        return oss.str();
-    }
-
-    Value parse_number() {
-        size_t start = pos;
-        if (str[pos] == '-') ++pos;
-        while (pos < str.size() && std::isdigit(str[pos])) ++pos;
-        bool is_double = false;
-        if (pos < str.size() && str[pos] == '.') {
-            is_double = true;
-            ++pos;
-            while (pos < str.size() && std::isdigit(str[pos])) ++pos;
-        }
-        if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')) {
-            is_double = true;
-            ++pos;
-            if (str[pos] == '+' || str[pos] == '-') ++pos;
-            while (pos < str.size() && std::isdigit(str[pos])) ++pos;
-        }
+namespace jsonn {
 
-        std::string num_str = str.substr(start, pos - start);
-        try {
-            if (is_double) return std::stod(num_str);
-            return std::stoi(num_str);
-        } catch (...) {
-            throw std::runtime_error("Invalid number: " + num_str + " at position " + std::to_string(start));
-        }
-    }
+Value parse(const char* data, size_t size) {
+    JSONN_STATS_SCOPE("parse", parse);
+    JSONN_STAT(st->bytes_parsed += size);
+    detail::ValueBuilder builder;
+    detail::Parser<false, detail::ValueBuilder> p(builder, data, size);
+    return p.parse_document();
+}
 
-    Value parse_true() {
-        if (str.substr(pos, 4) != "true") throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
-        pos += 4;
-        return true;
-    }
+Value parse(std::string_view json) {
+    return parse(json.data(), json.size());
+}
 
-    Value parse_false() {
-        if (str.substr(pos, 5) != "false") throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
-        pos += 5;
-        return false;
+Value parse(std::string_view json, const ParseOptions& options) {
+    JSONN_STATS_SCOPE("parse", parse);
+    JSONN_STAT(st->bytes_parsed += json.size());
+    detail::ValueBuilder builder;
+    builder.keys = options.keys;
+    // Index positions are 32-bit, larger inputs always take the scalar path
+    if (options.mode == ParseMode::scalar || json.size() > UINT32_MAX) {
+        detail::Parser<false, detail::ValueBuilder> p(builder, json.data(), json.size());
+        p.validate_utf8 = options.validate_utf8;
+        p.max_depth = options.max_depth;
+        return p.parse_document();
     }
+    std::vector<uint32_t> index;
+    detail::build_structural_index(json.data(), json.size(), index);
+    detail::Parser<true, detail::ValueBuilder> p(builder, json.data(), json.size(), index);
+    p.validate_utf8 = options.validate_utf8;
+    p.max_depth = options.max_depth;
+    return p.parse_document();
+}
 
-    Value parse_null() {
-        if (str.substr(pos, 4) != "null") throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
-        pos += 4;
-        return nullptr;
-    }
-};
+const char* simd_kernel() {
+    return detail::kernel_name(detail::best_kernel());
+}
 
-Value parse(const std::string& json) {
-    Parser p(json);
-    Value v = p.parse_value();
-    p.skip_whitespace();
-    if (p.get_pos() != json.size()) throw std::runtime_error("Extra data after JSON at position " + std::to_string(p.get_pos()));
-    return v;
+Value parse_file(const std::string& path) {
+    detail::MappedFile file(path);
+    return parse(file.data, file.size);
 }
 
 } // namespace jsonn
@@ -0,0 +1,337 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#include "jsonn.h"
+#include "jsonn_number.h"
+#include "jsonn_stats.h"
+#include "jsonn_string.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonn::detail {
+
+enum : uint8_t { C_WS = 1, C_DELIM = 2, C_DIGIT = 4 };
+
+// Byte classes for JSON, without the locale lookups of std::isspace/isdigit
+struct CharTable {
+    uint8_t cls[256] = {};
+    constexpr CharTable() {
+        for (char c : {' ', '\t', '\n', '\r'}) cls[static_cast<unsigned char>(c)] = C_WS | C_DELIM;
+        for (char c : {'{', '}', '[', ']', ':', ','}) cls[static_cast<unsigned char>(c)] = C_DELIM;
+        for (char c = '0'; c <= '9'; ++c) cls[static_cast<unsigned char>(c)] = C_DIGIT;
+    }
+};
+inline constexpr CharTable char_table;
+
+inline bool is_ws(char c) { return char_table.cls[static_cast<unsigned char>(c)] & C_WS; }
+inline bool is_delim(char c) { return char_table.cls[static_cast<unsigned char>(c)] & C_DELIM; }
+inline bool is_digit(char c) { return char_table.cls[static_cast<unsigned char>(c)] & C_DIGIT; }
+
+// Builds the regular Value tree. With a KeyTable, objects follow its shapes
+// and take a shared key list at the end instead of storing their own keys.
+struct ValueBuilder {
+    using value_type = Value;
+    using array_frame = Array;
+    struct object_frame {
+        Object obj;
+        std::string key;
+        KeyTable::Shape* shape = nullptr;
+        uint32_t slot = 0;
+    };
+
+    KeyTable* keys = nullptr;
+
+    Value make_null() { return nullptr; }
+    Value make_bool(bool b) { return b; }
+    Value make_int(int64_t i) { return i; }
+    Value make_uint(uint64_t u) { return u; }
+    Value make_double(double d) { return d; }
+    Value make_string(std::string_view s) {
+        Value v;
+        v.data.emplace<std::string>(s);
+        JSONN_STAT(if (s.size() > std::string().capacity()) { ++st->allocations; st->allocated_bytes += s.size() + 1; });
+        return v;
+    }
+
+    Array begin_array() { return {}; }
+    void push(Array& arr, Value&& v) { arr.push_back(std::move(v)); }
+    Value end_array(Array& arr) {
+        JSONN_STAT(if (arr.capacity()) { ++st->allocations; st->allocated_bytes += arr.capacity() * sizeof(Value); });
+        Value v;
+        v.data = std::move(arr);
+        return v;
+    }
+
+    object_frame begin_object() {
+        object_frame f;
+        if (keys) f.shape = keys->root();
+        return f;
+    }
+    void key(object_frame& f, std::string_view k) {
+        if (f.shape) {
+            if (KeyTable::Shape* next = keys->step(f.shape, k, f.slot)) {
+                f.shape = next;
+                return;
+            }
+            // The table is full, carry on with the keys so far
+            KeyTable::attach(f.obj, f.shape);
+            f.shape = nullptr;
+        }
+        f.key.assign(k);
+    }
+    void member(object_frame& f, Value&& v) {
+        if (!f.shape) {
+            f.obj.insert_or_assign(std::move(f.key), std::move(v));
+        } else if (f.slot == f.obj.values.size()) {
+            f.obj.values.push_back(std::move(v));
+        } else {
+            f.obj.values[f.slot] = std::move(v);
+        }
+    }
+    Value end_object(object_frame& f) {
+        if (f.shape) KeyTable::attach(f.obj, f.shape);
+        // Interned key lists are shared, only the values are the object's own
+        JSONN_STAT(if (f.obj.values.capacity()) { ++st->allocations; st->allocated_bytes += f.obj.values.capacity() * sizeof(Value); });
+        Value v;
+        v.data = std::move(f.obj);
+        return v;
+    }
+};
+
+// Recursive descent parser. The Builder decides what gets built from the
+// tokens (see ValueBuilder). Indexed parsers take token positions from a
+// stage 1 structural index instead of skipping whitespace byte by byte.
+template <bool Indexed, class Builder>
+class Parser {
+    using V = typename Builder::value_type;
+
+    Builder& b;
+    const char* str;
+    size_t len;
+    size_t pos;
+    const uint32_t* index = nullptr;
+    size_t token = 0;
+    size_t tokens = 0;
+    std::string scratch; // decoded string contents
+    size_t depth = 0;
+
+public:
+    bool validate_utf8 = true;
+    size_t max_depth = 1024;
+
+    Parser(Builder& builder, const char* data, size_t size)
+        : b(builder), str(data), len(size), pos(0) {}
+    // Indexed parsers can start at any token, which lets a value nested in a
+    // document be parsed on its own with parse_value()
+    Parser(Builder& builder, const char* data, size_t size, const std::vector<uint32_t>& idx, size_t first = 0)
+        : b(builder), str(data), len(size), pos(0), index(idx.data()), token(first), tokens(idx.size()) {}
+
+    void skip_whitespace() {
+        if constexpr (Indexed) {
+            pos = token < tokens ? index[token] : len;
+        } else {
+            while (pos < len && is_ws(str[pos])) ++pos;
+        }
+    }
+
+    size_t get_pos() { return pos; }
+
+    char peek() {
+        skip_whitespace();
+        if (pos >= len) throw std::runtime_error("Unexpected end of input at position " + std::to_string(pos));
+        return str[pos];
+    }
+
+    char get() {
+        skip_whitespace();
+        if (pos >= len) throw std::runtime_error("Unexpected end of input at position " + std::to_string(pos));
+        if constexpr (Indexed) ++token;
+        return str[pos++];
+    }
+
+    V parse_value() {
+        char c = peek();
+        if (c == '{') return parse_object();
+        if (c == '[') return parse_array();
+        if (c == '"') {
+            JSONN_STAT(++st->strings);
+            return b.make_string(parse_string());
+        }
+        if (is_digit(c) || c == '-') return parse_number();
+        if (c == 't') return parse_true();
+        if (c == 'f') return parse_false();
+        if (c == 'n') return parse_null();
+        throw std::runtime_error("Unexpected character: " + std::string(1, c) + " at position " + std::to_string(pos));
+    }
+
+    // Parses a whole document, nothing but whitespace may follow the value
+    V parse_document() {
+        V v = parse_value();
+        skip_whitespace();
+        if (pos != len) throw std::runtime_error("Extra data after JSON at position " + std::to_string(pos));
+        return v;
+    }
+
+private:
+    V parse_object() {
+        get(); // consume '{'
+        enter();
+        JSONN_STAT(++st->objects);
+        auto frame = b.begin_object();
+        skip_whitespace();
+        if (peek() == '}') { get(); leave(); return b.end_object(frame); }
+
+        while (true) {
+            if (peek() != '"') throw std::runtime_error("Expected string key at position " + std::to_string(pos));
+            b.key(frame, parse_string());
+            if (get() != ':') throw std::runtime_error("Expected ':' after key at position " + std::to_string(pos));
+            b.member(frame, parse_value());
+
+            char c = get();
+            if (c == '}') break;
+            if (c != ',') throw std::runtime_error("Expected ',' in object at position " + std::to_string(pos));
+        }
+        leave();
+        return b.end_object(frame);
+    }
+
+    V parse_array() {
+        get(); // consume '['
+        enter();
+        JSONN_STAT(++st->arrays);
+        auto frame = b.begin_array();
+        skip_whitespace();
+        if (peek() == ']') { get(); leave(); return b.end_array(frame); }
+
+        while (true) {
+            b.push(frame, parse_value());
+            char c = get();
+            if (c == ']') break;
+            if (c != ',') throw std::runtime_error("Expected ',' in array at position " + std::to_string(pos));
+        }
+        leave();
+        return b.end_array(frame);
+    }
+
+    // Called just past an opening bracket
+    void enter() {
+        if (++depth > max_depth) throw std::runtime_error("Nesting too deep at position " + std::to_string(pos - 1));
+        JSONN_STAT(st->max_depth = std::max(st->max_depth, static_cast<uint32_t>(depth)));
+    }
+
+    void leave() {
+        --depth;
+    }
+
+    // The returned view points into the input when the string has no
+    // escapes, otherwise into scratch until the next string is parsed
+    std::string_view parse_string() {
+        get(); // consume '"'
+        std::string_view s;
+        pos = scan_string(str, len, pos, s, scratch, validate_utf8);
+        return s;
+    }
+
+    // Scalars other than strings are single index entries, and the index
+    // doesn't mark where they end, so check nothing is glued on to them.
+    // Both modes check, so "truex" fails at the x either way.
+    void begin_scalar() {
+        if constexpr (Indexed) ++token;
+    }
+
+    void end_scalar() {
+        if (pos < len && !is_delim(str[pos]) && str[pos] != '"') {
+            throw std::runtime_error("Unexpected character: " + std::string(1, str[pos]) + " at position " + std::to_string(pos));
+        }
+    }
+
+    V parse_number() {
+        begin_scalar();
+        V v = scan_number();
+        end_scalar();
+        return v;
+    }
+
+    V scan_number() {
+        Number n;
+        pos = detail::scan_number(str, len, pos, n);
+        switch (n.kind) {
+            case Number::integer:
+                JSONN_STAT(++st->integers);
+                return b.make_int(n.i);
+            case Number::unsigned_integer:
+                JSONN_STAT(++st->integers);
+                return b.make_uint(n.u);
+            default:
+                JSONN_STAT(++st->doubles);
+                return b.make_double(n.d);
+        }
+    }
+
+    bool match_literal(const char* lit, size_t n) {
+        return len - pos >= n && std::memcmp(str + pos, lit, n) == 0;
+    }
+
+    V parse_true() {
+        if (!match_literal("true", 4)) throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
+        begin_scalar();
+        pos += 4;
+        end_scalar();
+        JSONN_STAT(++st->bools);
+        return b.make_bool(true);
+    }
+
+    V parse_false() {
+        if (!match_literal("false", 5)) throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
+        begin_scalar();
+        pos += 5;
+        end_scalar();
+        JSONN_STAT(++st->bools);
+        return b.make_bool(false);
+    }
+
+    V parse_null() {
+        if (!match_literal("null", 4)) throw std::runtime_error("Invalid literal at position " + std::to_string(pos));
+        begin_scalar();
+        pos += 4;
+        end_scalar();
+        JSONN_STAT(++st->nulls);
+        return b.make_null();
+    }
+};
+
+} // namespace jsonn::detail
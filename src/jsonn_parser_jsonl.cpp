@@ -30,63 +30,183 @@
 */
 
 #include "jsonn.h"
+#include "jsonn_jsonl.h"
+#include "jsonn_parallel.h"
+#include "jsonn_stats.h"
+#include <algorithm>
+#include <cstring>
 #include <exception>
-#include <sstream>
+#include <stdexcept>
 #include <vector>
-#include <mutex>
-#include <thread>
 
 namespace jsonn {
-__attribute__((visibility("default"))) 
-std::vector<Value> parse_jsonl(const std::string& jsonl) {
-    std::vector<std::string> lines_tmp;
-    std::stringstream ss(jsonl);
-    std::string line_tmp;
-
-    while (std::getline(ss, line_tmp)) {
-        if (!line_tmp.empty() && line_tmp.back() == '\r') {
-            line_tmp.pop_back();
-        }
-        if (!line_tmp.empty()) {
-            lines_tmp.push_back(line_tmp);
+
+namespace {
+
+// Cuts text into pieces of roughly chunk bytes that end on line boundaries
+std::vector<std::string_view> split_chunks(std::string_view text, size_t chunk) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = begin + chunk;
+        if (end >= text.size()) {
+            end = text.size();
+        } else {
+            const void* nl = std::memchr(text.data() + end, '\n', text.size() - end);
+            end = nl ? static_cast<const char*>(nl) - text.data() + 1 : text.size();
         }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
     }
+    return chunks;
+}
 
-    std::vector<Value> result_values(lines_tmp.size());
-    std::mutex exception_mutex;
-    std::exception_ptr first_exception = nullptr;
+// Turns chunk-relative line numbers into 1-based ones for the whole input.
+// Chunks end on line boundaries, so a chunk starts where the lines of the
+// ones before it end.
+template <class T>
+void number_lines(std::vector<std::vector<T>>& parts, const std::vector<size_t>& lines) {
+    size_t base = 1;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        for (T& item : parts[i]) item.line += base;
+        base += lines[i];
+    }
+}
 
-    auto worker = [&](size_t start, size_t end) {
+template <class T>
+std::vector<T> flatten(std::vector<std::vector<T>>& parts) {
+    if (parts.size() == 1) return std::move(parts[0]);
+    std::vector<T> result;
+    size_t total = 0;
+    for (auto& part : parts) total += part.size();
+    result.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+} // namespace
+
+namespace detail {
+
+void run_jsonl_chunks(std::string_view jsonl, const ParallelOptions& options,
+                      const std::function<void(size_t)>& count, const std::function<void(size_t, std::string_view)>& task) {
+    // Nested in parse_jsonl's own scope; standalone for parse_jsonl_as
+    JSONN_STATS_SCOPE("parse_jsonl", parse);
+    if (jsonl.size() < options.serial_threshold) {
+        count(1);
+        task(0, jsonl);
+        return;
+    }
+
+    JSONN_STATS_TIMER(split_start);
+    size_t workers = parallelism(options);
+    // Several chunks per worker leaves room for stealing around long lines
+    size_t chunk = options.chunk_size ? options.chunk_size : std::max<size_t>(64 * 1024, jsonl.size() / (workers * 8));
+    std::vector<std::string_view> chunks = split_chunks(jsonl, chunk);
+    count(chunks.size());
+    JSONN_STAT(st->split_time += JSONN_STATS_ELAPSED(split_start); st->threads = static_cast<uint32_t>(workers));
+
+    std::vector<std::exception_ptr> errors(chunks.size());
+    detail::StatsCall* call = JSONN_STATS_CALL();
+    std::function<void(size_t)> run = [&](size_t i) {
+        JSONN_STATS_TASK(call);
         try {
-            for (size_t i = start; i < end; ++i) {
-                result_values[i] = jsonn::parse(lines_tmp[i]);
-            }
+            task(i, chunks[i]);
         } catch (...) {
-            std::lock_guard<std::mutex> lock(exception_mutex);
-            if (!first_exception) first_exception = std::current_exception();
+            errors[i] = std::current_exception();
         }
     };
+    JSONN_STATS_TIMER(parallel_start);
+    run_parallel(options, chunks.size(), run);
+    JSONN_STAT(st->parallel_time += JSONN_STATS_ELAPSED(parallel_start));
 
-    const size_t num_threads = std::thread::hardware_concurrency();
-    std::vector<std::thread> threads;
-    size_t block_size = (lines_tmp.size() + num_threads - 1) / num_threads;
+    // Report the error that comes first in the input
+    for (auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+}
 
-    for (size_t t = 0; t < num_threads; ++t) {
-        size_t start = t * block_size;
-        size_t end = std::min(start + block_size, lines_tmp.size());
-        if (start < end) {
-            threads.emplace_back(worker, start, end);
+void JsonlErrors::finish() {
+    number_lines(errors, lines);
+    for (auto& part : errors) {
+        if (part.empty()) continue;
+        if (!options.skip_errors) throw std::runtime_error("Line " + std::to_string(part[0].line) + ": " + part[0].message);
+        if (options.on_error) {
+            for (const JsonlError& e : part) options.on_error(e);
         }
     }
+}
 
-    for (auto& th : threads) {
-        th.join();
-    }
+void parse_jsonl_chunks(std::string_view jsonl, const ParallelOptions& options,
+                        const std::function<void(size_t)>& count,
+                        const std::function<void(size_t, std::string_view)>& parse_line) {
+    JsonlErrors errors(jsonl, options);
+    auto chunks = [&](size_t n) {
+        count(n);
+        errors.resize(n);
+    };
+    run_jsonl_chunks(jsonl, options, chunks, [&](size_t i, std::string_view chunk) {
+        errors.parse_chunk(i, chunk, [&](std::string_view line) { parse_line(i, line); });
+    });
+    errors.finish();
+}
 
-    if (first_exception) {
-        std::rethrow_exception(first_exception);
-    }
+} // namespace detail
 
+std::vector<Value> parse_jsonl(std::string_view jsonl, const ParallelOptions& options) {
+    JSONN_STATS_SCOPE("parse_jsonl", parse);
+    std::vector<std::vector<Value>> parts;
+    detail::JsonlErrors errors(jsonl, options);
+    auto count = [&](size_t n) {
+        parts.resize(n);
+        errors.resize(n);
+    };
+    detail::run_jsonl_chunks(jsonl, options, count, [&](size_t i, std::string_view chunk) {
+        // Keys are interned in a table local to the task, so tasks share no state
+        KeyTable keys;
+        ParseOptions parse_options = options.parse;
+        parse_options.keys = options.intern_keys ? &keys : nullptr;
+        errors.parse_chunk(i, chunk, [&](std::string_view line) { parts[i].push_back(parse(line, parse_options)); });
+    });
+    errors.finish();
+
+    JSONN_STATS_TIMER(merge_start);
+    std::vector<Value> result_values = flatten(parts);
+    JSONN_STAT(st->merge_time += JSONN_STATS_ELAPSED(merge_start));
     return result_values;
 }
+
+std::vector<JsonlLine> parse_jsonl_lines(std::string_view jsonl, const ParallelOptions& options) {
+    JSONN_STATS_SCOPE("parse_jsonl_lines", parse);
+    std::vector<std::vector<JsonlLine>> parts;
+    std::vector<size_t> lines;
+    auto count = [&](size_t n) {
+        parts.resize(n);
+        lines.resize(n);
+    };
+    detail::run_jsonl_chunks(jsonl, options, count, [&](size_t i, std::string_view chunk) {
+        KeyTable keys;
+        ParseOptions parse_options = options.parse;
+        parse_options.keys = options.intern_keys ? &keys : nullptr;
+        lines[i] = detail::for_each_line(chunk, [&](std::string_view line, size_t number) {
+            JsonlLine& result = parts[i].emplace_back();
+            result.line = number;
+            result.offset = static_cast<size_t>(line.data() - jsonl.data());
+            try {
+                result.value = parse(line, parse_options);
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            return true;
+        });
+    });
+
+    number_lines(parts, lines);
+    JSONN_STATS_TIMER(merge_start);
+    std::vector<JsonlLine> result_lines = flatten(parts);
+    JSONN_STAT(st->merge_time += JSONN_STATS_ELAPSED(merge_start));
+    return result_lines;
+}
 }
@@ -0,0 +1,255 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "jsonn.h"
+#include "jsonn_parallel.h"
+#include "jsonn_parser.h"
+#include "jsonn_simd.h"
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace jsonn {
+
+namespace {
+
+constexpr uint32_t no_key = UINT32_MAX;
+
+// A value one task parses: the element starting at token, and for members
+// of a split object the key token before it. depth counts the containers
+// around it.
+struct Item {
+    uint32_t token;
+    uint32_t key;
+    size_t bytes;
+    size_t depth;
+};
+
+// A member of the root. Large containers are split, their members become
+// items of their own and the container is rebuilt around them.
+struct Part {
+    uint32_t token;
+    bool split;
+    size_t first; // items
+    size_t count;
+};
+
+// Walks the top two levels of a document on its structural index. It only
+// checks the separators between the members it visits; everything inside
+// them is left to the parser. Any mistake it finds sends the whole input
+// back to the serial parser, which reports it with the usual message.
+class Splitter {
+public:
+    Splitter(const char* data, const std::vector<uint32_t>& index) : str(data), index(index), tokens(static_cast<uint32_t>(index.size())) {}
+
+    char at(uint32_t t) const { return str[index[t]]; }
+    bool is_container(uint32_t t) const { return at(t) == '{' || at(t) == '['; }
+    size_t bytes(uint32_t t, uint32_t end) const { return index[end] - index[t]; }
+
+    // Token after the value starting at t, none if its brackets don't close
+    uint32_t skip(uint32_t t) const {
+        if (!is_container(t)) return t + 1;
+        uint32_t depth = 0;
+        for (; t < tokens; ++t) {
+            char c = at(t);
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return t + 1;
+            }
+        }
+        return no_key;
+    }
+
+    // Calls fn(key, value, end) for each member of the container at t and
+    // returns the token after it, or no_key if the container is malformed
+    template <class F>
+    uint32_t members(uint32_t t, F&& fn) const {
+        bool object = at(t) == '{';
+        char close = object ? '}' : ']';
+        if (++t < tokens && at(t) == close) return t + 1;
+        while (true) {
+            uint32_t key = no_key;
+            if (object) {
+                if (t + 1 >= tokens || at(t) != '"' || at(t + 1) != ':') return no_key;
+                key = t;
+                t += 2;
+            }
+            if (t >= tokens) return no_key;
+            char c = at(t);
+            if (c == ',' || c == ':' || c == '}' || c == ']') return no_key;
+            uint32_t end = skip(t);
+            if (end >= tokens) return no_key;
+            if (!fn(key, t, end)) return no_key;
+            t = end;
+            if (at(t) == close) return t + 1;
+            if (at(t) != ',') return no_key;
+            ++t;
+        }
+    }
+
+private:
+    const char* str;
+    const std::vector<uint32_t>& index;
+    uint32_t tokens;
+};
+
+} // namespace
+
+Value parse_parallel(std::string_view json, const ParallelOptions& options) {
+    JSONN_STATS_SCOPE("parse_parallel", parse);
+    if (json.size() < options.serial_threshold || json.size() > UINT32_MAX) return parse(json, options.parse);
+
+    JSONN_STATS_TIMER(split_start);
+    const char* data = json.data();
+    const bool validate = options.parse.validate_utf8;
+    std::vector<uint32_t> index;
+    try {
+        detail::build_structural_index(data, json.size(), index);
+    } catch (const std::exception&) {
+        // Let the serial parser report it, it may find an earlier error
+        // first and its scalar mode never builds an index
+        return parse(json, options.parse);
+    }
+    Splitter splitter(data, index);
+    if (index.empty() || !splitter.is_container(0) || options.parse.max_depth < 2) return parse(json, options.parse);
+
+    size_t workers = detail::parallelism(options);
+    size_t chunk = options.chunk_size ? options.chunk_size : std::max<size_t>(64 * 1024, json.size() / (workers * 8));
+
+    // Root keys are decoded here, so the tasks only ever fail inside values
+    // and the first failing item holds the first error in the input
+    std::vector<Item> items;
+    std::vector<Part> parts;
+    std::vector<std::string> root_keys;
+    bool root_object = splitter.at(0) == '{';
+    uint32_t root_end = splitter.members(0, [&](uint32_t key, uint32_t t, uint32_t end) {
+        if (key != no_key) {
+            try {
+                detail::decode_string(data, json.size(), index[key] + 1, root_keys.emplace_back(), 0, validate);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        Part part{t, false, items.size(), 1};
+        if (splitter.bytes(t, end) >= chunk && splitter.is_container(t)) {
+            part.split = true;
+            uint32_t inner = splitter.members(t, [&](uint32_t k, uint32_t v, uint32_t e) {
+                items.push_back({v, k, splitter.bytes(v, e), 2});
+                return true;
+            });
+            if (inner != end) return false;
+            part.count = items.size() - part.first;
+        } else {
+            items.push_back({t, no_key, splitter.bytes(t, end), 1});
+        }
+        parts.push_back(part);
+        return true;
+    });
+    if (root_end != index.size()) return parse(json, options.parse);
+
+    // Contiguous runs of items of about chunk bytes each
+    std::vector<size_t> runs{0};
+    size_t run_bytes = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (run_bytes >= chunk) {
+            runs.push_back(i);
+            run_bytes = 0;
+        }
+        run_bytes += items[i].bytes;
+    }
+    runs.push_back(items.size());
+    if (runs.size() <= 2) return parse(json, options.parse);
+    JSONN_STAT(st->bytes_parsed += json.size(); st->split_time += JSONN_STATS_ELAPSED(split_start); st->threads = static_cast<uint32_t>(workers));
+
+    std::vector<Value> values(items.size());
+    std::vector<std::string> keys(items.size());
+    std::vector<std::exception_ptr> errors(runs.size() - 1);
+    detail::StatsCall* call = JSONN_STATS_CALL();
+    JSONN_STATS_TIMER(parallel_start);
+    detail::run_parallel(options, runs.size() - 1, [&](size_t r) {
+        JSONN_STATS_TASK(call);
+        try {
+            KeyTable table;
+            detail::ValueBuilder builder;
+            builder.keys = options.intern_keys ? &table : nullptr;
+            for (size_t i = runs[r]; i < runs[r + 1]; ++i) {
+                const Item& item = items[i];
+                if (item.key != no_key) detail::decode_string(data, json.size(), index[item.key] + 1, keys[i], 0, validate);
+                detail::Parser<true, detail::ValueBuilder> p(builder, data, json.size(), index, item.token);
+                p.validate_utf8 = validate;
+                p.max_depth = options.parse.max_depth - item.depth;
+                values[i] = p.parse_value();
+            }
+        } catch (...) {
+            errors[r] = std::current_exception();
+        }
+    });
+    JSONN_STAT(st->parallel_time += JSONN_STATS_ELAPSED(parallel_start));
+
+    // Runs are in input order, so this is the error the serial parser hits
+    for (auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+
+    JSONN_STATS_TIMER(merge_start);
+    auto take = [&](const Part& part) -> Value {
+        if (!part.split) return std::move(values[part.first]);
+        if (splitter.at(part.token) == '[') {
+            Array arr;
+            arr.reserve(part.count);
+            for (size_t i = part.first; i < part.first + part.count; ++i) arr.push_back(std::move(values[i]));
+            return Value(std::move(arr));
+        }
+        Object obj;
+        obj.reserve(part.count);
+        for (size_t i = part.first; i < part.first + part.count; ++i) obj.insert_or_assign(std::move(keys[i]), std::move(values[i]));
+        return Value(std::move(obj));
+    };
+
+    Value result;
+    if (root_object) {
+        Object obj;
+        obj.reserve(parts.size());
+        for (size_t i = 0; i < parts.size(); ++i) obj.insert_or_assign(std::move(root_keys[i]), take(parts[i]));
+        result = Value(std::move(obj));
+    } else {
+        Array arr;
+        arr.reserve(parts.size());
+        for (const Part& part : parts) arr.push_back(take(part));
+        result = Value(std::move(arr));
+    }
+    JSONN_STAT(st->merge_time += JSONN_STATS_ELAPSED(merge_start));
+    return result;
+}
+
+} // namespace jsonn
@@ -0,0 +1,338 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "jsonn.h"
+#include "jsonn_bind.h"
+#include <unordered_map>
+
+namespace jsonn {
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+[[noreturn]] void invalid(std::string_view path) {
+    throw std::runtime_error("Invalid path: " + std::string(path));
+}
+
+// Array index per RFC 6901: digits without leading zeros
+size_t as_index(std::string_view s) {
+    if (s.empty() || s.size() > 18 || (s[0] == '0' && s.size() > 1)) return npos;
+    size_t i = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return npos;
+        i = i * 10 + static_cast<size_t>(c - '0');
+    }
+    return i;
+}
+
+} // namespace
+
+Path::Path(std::string_view path) {
+    auto add = [&](std::string key, bool wildcard) {
+        size_t index = wildcard ? npos : as_index(key);
+        steps.push_back(Step{std::move(key), index, wildcard});
+    };
+
+    if (path.empty() || path[0] == '/') {
+        // JSON pointer, the empty pointer is the whole document
+        size_t pos = 0;
+        while (pos < path.size()) {
+            size_t end = path.find('/', pos + 1);
+            if (end == npos) end = path.size();
+            std::string key;
+            for (size_t i = pos + 1; i < end; ++i) {
+                if (path[i] != '~') {
+                    key.push_back(path[i]);
+                } else if (i + 1 < end && (path[i + 1] == '0' || path[i + 1] == '1')) {
+                    key.push_back(path[++i] == '0' ? '~' : '/');
+                } else {
+                    invalid(path);
+                }
+            }
+            add(std::move(key), false);
+            pos = end;
+        }
+        return;
+    }
+
+    if (path[0] != '$') invalid(path);
+    size_t pos = 1;
+    while (pos < path.size()) {
+        if (path[pos] == '.') {
+            size_t begin = ++pos;
+            while (pos < path.size() && path[pos] != '.' && path[pos] != '[') ++pos;
+            if (pos == begin) invalid(path);
+            std::string_view name = path.substr(begin, pos - begin);
+            add(std::string(name), name == "*");
+        } else if (path[pos] == '[') {
+            size_t close = path.find(']', pos);
+            if (close == npos) invalid(path);
+            std::string_view inner = path.substr(pos + 1, close - pos - 1);
+            if (inner == "*") {
+                add({}, true);
+            } else if (inner.size() >= 2 && (inner[0] == '\'' || inner[0] == '"') && inner.back() == inner[0]) {
+                add(std::string(inner.substr(1, inner.size() - 2)), false);
+            } else if (as_index(inner) != npos) {
+                add(std::string(inner), false);
+            } else {
+                invalid(path);
+            }
+            pos = close + 1;
+        } else {
+            invalid(path);
+        }
+    }
+}
+
+template <class V>
+V* Path::find_from(V* v, size_t step) const {
+    for (; step < steps.size(); ++step) {
+        const Step& s = steps[step];
+        auto* obj = std::get_if<Object>(&v->data);
+        auto* arr = std::get_if<Array>(&v->data);
+        if (s.wildcard) {
+            if (obj) {
+                for (auto&& [key, child] : *obj) {
+                    if (V* found = find_from(&child, step + 1)) return found;
+                }
+            } else if (arr) {
+                for (auto& child : *arr) {
+                    if (V* found = find_from(&child, step + 1)) return found;
+                }
+            }
+            return nullptr;
+        }
+        if (obj) {
+            auto it = obj->find(s.key);
+            if (it == obj->end()) return nullptr;
+            v = &(*it).second;
+        } else if (arr && s.index < arr->size()) {
+            v = &(*arr)[s.index];
+        } else {
+            return nullptr;
+        }
+    }
+    return v;
+}
+
+const Value* Path::find(const Value& root) const {
+    return find_from(&root, 0);
+}
+
+Value* Path::find(Value& root) const {
+    return find_from(&root, 0);
+}
+
+namespace {
+
+// Members of a Document object the way a parsed Object holds them: in the
+// order keys first appear, each with its last value
+std::vector<Element> object_members(Element e) {
+    std::vector<Element> members;
+    std::unordered_map<std::string_view, size_t> seen;
+    for (auto [key, child] : e.as_object()) {
+        auto [it, added] = seen.try_emplace(key, members.size());
+        if (added) members.push_back(child);
+        else members[it->second] = child;
+    }
+    return members;
+}
+
+} // namespace
+
+// Same walk over a Document
+std::optional<Element> Path::find_from(Element e, size_t step) const {
+    for (; step < steps.size(); ++step) {
+        const Step& s = steps[step];
+        if (s.wildcard) {
+            if (e.is_object()) {
+                for (Element child : object_members(e)) {
+                    if (auto found = find_from(child, step + 1)) return found;
+                }
+            } else if (e.is_array()) {
+                for (Element child : e.as_array()) {
+                    if (auto found = find_from(child, step + 1)) return found;
+                }
+            }
+            return std::nullopt;
+        }
+        if (e.is_object()) {
+            auto found = e.find(s.key);
+            if (!found) return std::nullopt;
+            e = *found;
+        } else if (e.is_array() && s.index < e.as_array().size()) {
+            e = e.as_array()[s.index];
+        } else {
+            return std::nullopt;
+        }
+    }
+    return e;
+}
+
+std::optional<Element> Path::find(Element root) const {
+    return find_from(root, 0);
+}
+
+void Path::find_all(const Value& root, std::vector<const Value*>& out) const {
+    std::function<void(const Value&, size_t)> walk = [&](const Value& v, size_t step) {
+        if (step == steps.size()) {
+            out.push_back(&v);
+            return;
+        }
+        const Step& s = steps[step];
+        if (auto* obj = std::get_if<Object>(&v.data)) {
+            if (s.wildcard) {
+                for (const auto& [key, child] : *obj) walk(child, step + 1);
+            } else if (auto it = obj->find(s.key); it != obj->end()) {
+                walk((*it).second, step + 1);
+            }
+        } else if (auto* arr = std::get_if<Array>(&v.data)) {
+            if (s.wildcard) {
+                for (const Value& child : *arr) walk(child, step + 1);
+            } else if (s.index < arr->size()) {
+                walk((*arr)[s.index], step + 1);
+            }
+        }
+    };
+    walk(root, 0);
+}
+
+void Path::find_all(Element root, std::vector<Element>& out) const {
+    std::function<void(Element, size_t)> walk = [&](Element e, size_t step) {
+        if (step == steps.size()) {
+            out.push_back(e);
+            return;
+        }
+        const Step& s = steps[step];
+        if (e.is_object()) {
+            if (s.wildcard) {
+                for (Element child : object_members(e)) walk(child, step + 1);
+            } else if (auto found = e.find(s.key)) {
+                walk(*found, step + 1);
+            }
+        } else if (e.is_array()) {
+            if (s.wildcard) {
+                for (Element child : e.as_array()) walk(child, step + 1);
+            } else if (s.index < e.as_array().size()) {
+                walk(e.as_array()[s.index], step + 1);
+            }
+        }
+    };
+    walk(root, 0);
+}
+
+// Walks the text along the steps, skipping everything off the path
+bool Path::extract_from(Reader& r, size_t step, const std::function<bool(Value&&)>& fn) const {
+    if (step == steps.size()) return fn(r.read_value());
+    const Step& s = steps[step];
+    char c = r.peek();
+    if (c == '{') {
+        r.begin_object();
+        std::string_view key;
+        while (r.next_key(key)) {
+            if (s.wildcard || key == s.key) {
+                if (!extract_from(r, step + 1, fn)) return false;
+            } else {
+                r.skip();
+            }
+        }
+    } else if (c == '[') {
+        r.begin_array();
+        for (size_t i = 0; r.next_element(); ++i) {
+            if (s.wildcard || i == s.index) {
+                if (!extract_from(r, step + 1, fn)) return false;
+            } else {
+                r.skip();
+            }
+        }
+    } else {
+        r.skip();
+    }
+    return true;
+}
+
+// find_from on the text. A repeated key replaces what the earlier one
+// matched, as it replaces the value in a parsed object, so objects are
+// always read to the end.
+std::optional<Value> Path::extract_first(Reader& r, size_t step) const {
+    if (step == steps.size()) return r.read_value();
+    const Step& s = steps[step];
+    std::optional<Value> found;
+    char c = r.peek();
+    if (c == '{') {
+        r.begin_object();
+        std::string_view key;
+        if (!s.wildcard) {
+            while (r.next_key(key)) {
+                if (key == s.key) found = extract_first(r, step + 1);
+                else r.skip();
+            }
+            return found;
+        }
+        // Members in the order of their first occurrence, as Object keeps them
+        std::vector<std::pair<std::string, std::optional<Value>>> members;
+        std::unordered_map<std::string, size_t> seen;
+        while (r.next_key(key)) {
+            auto [it, added] = seen.try_emplace(std::string(key), members.size());
+            if (added) members.emplace_back(key, std::nullopt);
+            members[it->second].second = extract_first(r, step + 1);
+        }
+        for (auto& m : members) {
+            if (m.second) return std::move(m.second);
+        }
+    } else if (c == '[') {
+        r.begin_array();
+        for (size_t i = 0; r.next_element(); ++i) {
+            if (!found && (s.wildcard || i == s.index)) found = extract_first(r, step + 1);
+            else r.skip();
+        }
+    } else {
+        r.skip();
+    }
+    return found;
+}
+
+std::optional<Value> Path::extract(std::string_view json, const ParseOptions& options) const {
+    Reader r(json, options);
+    std::optional<Value> result = extract_first(r, 0);
+    r.finish();
+    return result;
+}
+
+void Path::extract_all(std::string_view json, const std::function<void(Value&&)>& fn, const ParseOptions& options) const {
+    Reader r(json, options);
+    extract_from(r, 0, [&](Value&& v) { fn(std::move(v)); return true; });
+    r.finish();
+}
+
+} // namespace jsonn
@@ -0,0 +1,138 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jsonn {
+
+JsonlReader::JsonlReader(int fd, size_t buffer_size, const ParseOptions& options)
+    : fd(fd), owns_fd(false), options(options), buf(buffer_size ? buffer_size : 1) {
+    if (!this->options.keys) this->options.keys = &keys;
+}
+
+JsonlReader::JsonlReader(const std::string& path, size_t buffer_size, const ParseOptions& options)
+    : fd(::open(path.c_str(), O_RDONLY)), owns_fd(true), options(options), buf(buffer_size ? buffer_size : 1) {
+    if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+    if (!this->options.keys) this->options.keys = &keys;
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+JsonlReader::~JsonlReader() {
+    if (owns_fd) ::close(fd);
+}
+
+// Moves the unread tail to the front and reads more behind it. The buffer
+// only grows when a single line doesn't fit. Returns false at end of file.
+bool JsonlReader::fill() {
+    if (begin > 0) {
+        std::memmove(buf.data(), buf.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end == buf.size()) buf.resize(buf.size() * 2);
+
+    while (true) {
+        ssize_t n = ::read(fd, buf.data() + end, buf.size() - end);
+        if (n > 0) {
+            end += static_cast<size_t>(n);
+            return true;
+        }
+        if (n == 0) {
+            eof = true;
+            return false;
+        }
+        if (errno != EINTR) throw std::runtime_error(std::string("Read failed: ") + std::strerror(errno));
+    }
+}
+
+std::optional<std::string_view> JsonlReader::next_line() {
+    size_t scanned = begin;
+    while (true) {
+        // memchr is vectorized by the C library
+        const void* nl = std::memchr(buf.data() + scanned, '\n', end - scanned);
+        std::string_view text;
+        if (nl) {
+            size_t stop = static_cast<const char*>(nl) - buf.data();
+            text = std::string_view(buf.data() + begin, stop - begin);
+            begin = stop + 1;
+        } else {
+            // fill() moves the unread bytes, none of which is a newline, to the front
+            size_t unread = end - begin;
+            if (!eof && fill()) {
+                scanned = begin + unread;
+                continue;
+            }
+            if (unread == 0) return std::nullopt;
+            text = std::string_view(buf.data() + begin, unread);
+            begin = end;
+        }
+
+        ++line;
+        if (!text.empty() && text.back() == '\r') text.remove_suffix(1);
+        if (!text.empty()) return text;
+        scanned = begin;
+    }
+}
+
+bool JsonlReader::next(Value& out) {
+    auto text = next_line();
+    if (!text) return false;
+    try {
+        out = parse(*text, options);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Line " + std::to_string(line) + ": " + e.what());
+    }
+    return true;
+}
+
+size_t JsonlReader::next_batch(std::vector<Value>& out, size_t max_records) {
+    size_t added = 0;
+    Value v;
+    while (added < max_records && next(v)) {
+        out.push_back(std::move(v));
+        ++added;
+    }
+    return added;
+}
+
+void for_each_jsonl(const std::string& path, const std::function<void(Value&&)>& fn, size_t buffer_size) {
+    JsonlReader reader(path, buffer_size);
+    Value v;
+    while (reader.next(v)) fn(std::move(v));
+}
+
+} // namespace jsonn
@@ -0,0 +1,302 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include "jsonn_parser.h"
+#include "jsonn_simd.h"
+#include <cstring>
+
+namespace jsonn {
+
+namespace {
+
+// Turns the Parser's build steps into Handler events
+struct SaxBuilder {
+    struct Empty {};
+    using value_type = Empty;
+    using array_frame = Empty;
+    using object_frame = Empty;
+
+    Handler& h;
+
+    Empty make_null() { h.null_value(); return {}; }
+    Empty make_bool(bool b) { h.bool_value(b); return {}; }
+    Empty make_int(int64_t i) { h.int_value(i); return {}; }
+    Empty make_uint(uint64_t u) { h.uint_value(u); return {}; }
+    Empty make_double(double d) { h.double_value(d); return {}; }
+    Empty make_string(std::string_view s) { h.string_value(s); return {}; }
+
+    Empty begin_array() { h.start_array(); return {}; }
+    void push(Empty&, Empty&&) {}
+    Empty end_array(Empty&) { h.end_array(); return {}; }
+
+    Empty begin_object() { h.start_object(); return {}; }
+    void key(Empty&, std::string_view k) { h.key(k); }
+    void member(Empty&, Empty&&) {}
+    Empty end_object(Empty&) { h.end_object(); return {}; }
+};
+
+[[noreturn]] void fail(const std::string& what, size_t at) {
+    throw std::runtime_error(what + " at position " + std::to_string(at));
+}
+
+// Position of the closing quote in p[i, n), or n if the string goes on.
+// escape carries a trailing backslash over to the next chunk.
+size_t find_string_end(const char* p, size_t n, size_t i, bool& escape) {
+    for (; i < n; ++i) {
+        if (escape) {
+            escape = false;
+        } else if (p[i] == '\\') {
+            escape = true;
+        } else if (p[i] == '"') {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Numbers and literals run up to the next delimiter
+size_t find_scalar_end(const char* p, size_t n, size_t i) {
+    while (i < n && !detail::is_delim(p[i]) && p[i] != '"') ++i;
+    return i;
+}
+
+} // namespace
+
+void parse_sax(std::string_view json, Handler& handler, const ParseOptions& options) {
+    JSONN_STATS_SCOPE("parse_sax", parse);
+    JSONN_STAT(st->bytes_parsed += json.size());
+    SaxBuilder builder{handler};
+    if (options.mode == ParseMode::indexed && json.size() <= UINT32_MAX) {
+        std::vector<uint32_t> index;
+        detail::build_structural_index(json.data(), json.size(), index);
+        detail::Parser<true, SaxBuilder> p(builder, json.data(), json.size(), index);
+        p.validate_utf8 = options.validate_utf8;
+        p.max_depth = options.max_depth;
+        p.parse_document();
+    } else {
+        detail::Parser<false, SaxBuilder> p(builder, json.data(), json.size());
+        p.validate_utf8 = options.validate_utf8;
+        p.max_depth = options.max_depth;
+        p.parse_document();
+    }
+}
+
+// StreamParser
+
+void StreamParser::feed(std::string_view chunk) {
+    const char* p = chunk.data();
+    size_t n = chunk.size();
+    size_t i = token == Token::none ? 0 : continue_token(p, n);
+
+    while (i < n) {
+        char c = p[i];
+        if (detail::is_ws(c)) { ++i; continue; }
+
+        switch (state) {
+            case State::done:
+                fail("Extra data after JSON", offset + i);
+            case State::colon:
+                if (c != ':') fail("Expected ':' after key", offset + i);
+                state = State::value;
+                ++i;
+                break;
+            case State::after_value:
+                if (c == ',') {
+                    state = stack.back() == '[' ? State::value : State::key;
+                } else if (c == ']' || c == '}') {
+                    close(c, offset + i);
+                } else {
+                    fail(stack.back() == '[' ? "Expected ',' in array" : "Expected ',' in object", offset + i);
+                }
+                ++i;
+                break;
+            case State::first_key:
+                if (c == '}') { close(c, offset + i); ++i; break; }
+                [[fallthrough]];
+            case State::key:
+                if (c != '"') fail("Expected string key", offset + i);
+                i = start_string(p, n, i, Token::key);
+                break;
+            case State::first_value:
+                if (c == ']') { close(c, offset + i); ++i; break; }
+                [[fallthrough]];
+            case State::value:
+                if (c == '{' || c == '[') {
+                    if (stack.size() >= max_depth) fail("Nesting too deep", offset + i);
+                    open(c);
+                    ++i;
+                } else if (c == '"') {
+                    i = start_string(p, n, i, Token::string);
+                } else if (detail::is_digit(c) || c == '-') {
+                    i = start_scalar(p, n, i, Token::number);
+                } else if (c == 't' || c == 'f' || c == 'n') {
+                    i = start_scalar(p, n, i, Token::literal);
+                } else {
+                    fail("Unexpected character: " + std::string(1, c), offset + i);
+                }
+                break;
+        }
+    }
+    offset += n;
+}
+
+void StreamParser::finish() {
+    if (token == Token::string || token == Token::key) fail("Unterminated string", token_start);
+    if (token != Token::none) {
+        // End of input delimits a trailing number or literal
+        Token kind = token;
+        token = Token::none;
+        emit_scalar(partial.data(), partial.size(), token_start, kind);
+    }
+    if (state != State::done) fail("Unexpected end of input", offset);
+}
+
+void StreamParser::reset() {
+    stack.clear();
+    state = State::value;
+    token = Token::none;
+    escape = false;
+    token_start = 0;
+    offset = 0;
+    partial.clear();
+}
+
+// Completes a token split across chunks, returns where parsing resumes
+size_t StreamParser::continue_token(const char* p, size_t n) {
+    Token kind = token;
+    if (kind == Token::string || kind == Token::key) {
+        size_t end = find_string_end(p, n, 0, escape);
+        if (end == n) {
+            partial.append(p, n);
+            return n;
+        }
+        partial.append(p, end + 1);
+        token = Token::none;
+        emit_string(partial.data(), partial.size(), token_start, kind);
+        return end + 1;
+    }
+
+    size_t end = find_scalar_end(p, n, 0);
+    partial.append(p, end);
+    if (end == n) return n;
+    token = Token::none;
+    emit_scalar(partial.data(), partial.size(), token_start, kind);
+    return end;
+}
+
+size_t StreamParser::start_string(const char* p, size_t n, size_t i, Token kind) {
+    escape = false;
+    size_t end = find_string_end(p, n, i + 1, escape);
+    if (end == n) {
+        token = kind;
+        token_start = offset + i;
+        partial.assign(p + i, n - i);
+        return n;
+    }
+    emit_string(p + i, end + 1 - i, offset + i, kind);
+    return end + 1;
+}
+
+size_t StreamParser::start_scalar(const char* p, size_t n, size_t i, Token kind) {
+    size_t end = find_scalar_end(p, n, i);
+    if (end == n) {
+        token = kind;
+        token_start = offset + i;
+        partial.assign(p + i, n - i);
+        return n;
+    }
+    emit_scalar(p + i, end - i, offset + i, kind);
+    return end;
+}
+
+// s holds a whole string token including both quotes, base is its position
+void StreamParser::emit_string(const char* s, size_t n, size_t base, Token kind) {
+    scratch.clear();
+    detail::decode_string(s, n, 1, scratch, base, validate_utf8);
+    if (kind == Token::key) {
+        handler.key(scratch);
+        state = State::colon;
+    } else {
+        handler.string_value(scratch);
+        value_done();
+    }
+}
+
+void StreamParser::emit_scalar(const char* s, size_t n, size_t base, Token kind) {
+    if (kind == Token::number) {
+        detail::Number num;
+        if (detail::scan_number(s, n, 0, num, base) != n) {
+            fail("Invalid number: " + std::string(s, n), base);
+        }
+        switch (num.kind) {
+            case detail::Number::integer: handler.int_value(num.i); break;
+            case detail::Number::unsigned_integer: handler.uint_value(num.u); break;
+            case detail::Number::floating: handler.double_value(num.d); break;
+        }
+    } else if (n == 4 && std::memcmp(s, "true", 4) == 0) {
+        handler.bool_value(true);
+    } else if (n == 5 && std::memcmp(s, "false", 5) == 0) {
+        handler.bool_value(false);
+    } else if (n == 4 && std::memcmp(s, "null", 4) == 0) {
+        handler.null_value();
+    } else {
+        fail("Invalid literal", base);
+    }
+    value_done();
+}
+
+void StreamParser::open(char bracket) {
+    stack.push_back(bracket);
+    if (bracket == '{') {
+        handler.start_object();
+        state = State::first_key;
+    } else {
+        handler.start_array();
+        state = State::first_value;
+    }
+}
+
+void StreamParser::close(char bracket, size_t at) {
+    char expected = bracket == ']' ? '[' : '{';
+    if (stack.back() != expected) {
+        fail(stack.back() == '[' ? "Expected ',' in array" : "Expected ',' in object", at);
+    }
+    stack.pop_back();
+    if (bracket == ']') {
+        handler.end_array();
+    } else {
+        handler.end_object();
+    }
+    value_done();
+}
+
+} // namespace jsonn
@@ -30,48 +30,435 @@
 */
 
 #include "jsonn.h"
-#include <sstream>
+#include "jsonn_bind.h"
+#include "jsonn_stats.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace jsonn {
 
-// Forward declarations
-std::string serialize(const Array& a);
-std::string serialize(const Object& o);
+namespace {
 
-// Serialize Array
-std::string serialize(const Array& a) {
-    std::ostringstream oss;
-    oss << "[";
-    for (size_t i = 0; i < a.size(); ++i) {
-        oss << serialize(a[i]);
-        if (i + 1 < a.size()) oss << ",";
+// Characters that can't appear raw inside a JSON string
+struct EscapeTable {
+    bool needs[256] = {};
+    constexpr EscapeTable() {
+        for (int c = 0; c < 0x20; ++c) needs[c] = true;
+        needs[static_cast<unsigned char>('"')] = true;
+        needs[static_cast<unsigned char>('\\')] = true;
     }
-    oss << "]";
-    return oss.str();
+};
+constexpr EscapeTable escape_table;
+
+const char hex_digits[] = "0123456789abcdef";
+
+void append_u16(std::string& out, uint32_t unit) {
+    char u[6] = {'\\', 'u', hex_digits[(unit >> 12) & 0xf], hex_digits[(unit >> 8) & 0xf], hex_digits[(unit >> 4) & 0xf], hex_digits[unit & 0xf]};
+    out.append(u, 6);
+}
+
+// Escape for one character the table marks
+void append_escape(std::string& out, char c) {
+    switch (c) {
+        case '"':  out.append("\\\"", 2); break;
+        case '\\': out.append("\\\\", 2); break;
+        case '\n': out.append("\\n", 2); break;
+        case '\t': out.append("\\t", 2); break;
+        case '\r': out.append("\\r", 2); break;
+        case '\b': out.append("\\b", 2); break;
+        case '\f': out.append("\\f", 2); break;
+        default: append_u16(out, static_cast<unsigned char>(c));
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+void write_string(std::string& out, std::string_view s) {
+    out.push_back('"');
+    const char* p = s.data();
+    const char* end = p + s.size();
+    while (p < end) {
+        // Copy the longest run that doesn't need escaping in one go
+        const char* run = p;
+        while (p < end && !escape_table.needs[static_cast<unsigned char>(*p)]) ++p;
+        out.append(run, p - run);
+        if (p == end) break;
+        append_escape(out, *p++);
+    }
+    out.push_back('"');
+}
+
+void write_int(std::string& out, int64_t i) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), i);
+    out.append(buf, res.ptr - buf);
+}
+
+void write_uint(std::string& out, uint64_t u) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), u);
+    out.append(buf, res.ptr - buf);
+}
+
+void write_double(std::string& out, double d) {
+    // JSON has no representation for NaN or infinity
+    if (!std::isfinite(d)) { out.append("null", 4); return; }
+
+    // Shortest representation that parses back to the same double
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), d);
+    out.append(buf, res.ptr - buf);
+
+    // Keep integral doubles recognisable as doubles when parsed again
+    for (const char* p = buf; p < res.ptr; ++p) {
+        if (*p == '.' || *p == 'e') return;
+    }
+    out.append(".0", 2);
 }
 
-// Serialize Object
-std::string serialize(const Object& o) {
-    std::ostringstream oss;
-    oss << "{";
-    size_t count = 0;
-    for (const auto& [key, val] : o) {
-        oss << "\"" << key << "\":" << serialize(val);
-        if (++count < o.size()) oss << ",";
+} // namespace detail
+
+namespace {
+
+using detail::write_string;
+using detail::write_int;
+using detail::write_uint;
+using detail::write_double;
+
+void write_value(std::string& out, const Value& v) {
+    switch (v.data.index()) {
+        case 0: out.append("null", 4); break;
+        case 1: std::get<bool>(v.data) ? out.append("true", 4) : out.append("false", 5); break;
+        case 2: write_int(out, std::get<int64_t>(v.data)); break;
+        case 3: write_uint(out, std::get<uint64_t>(v.data)); break;
+        case 4: write_double(out, std::get<double>(v.data)); break;
+        case 5: write_string(out, std::get<std::string>(v.data)); break;
+        case 6: {
+            const Array& a = std::get<Array>(v.data);
+            out.push_back('[');
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (i) out.push_back(',');
+                write_value(out, a[i]);
+            }
+            out.push_back(']');
+            break;
+        }
+        case 7: {
+            const Object& o = std::get<Object>(v.data);
+            out.push_back('{');
+            bool first = true;
+            for (const auto& [key, val] : o) {
+                if (!first) out.push_back(',');
+                first = false;
+                write_string(out, key);
+                out.push_back(':');
+                write_value(out, val);
+            }
+            out.push_back('}');
+            break;
+        }
+    }
+}
+
+// Code point of the UTF-8 sequence at p and its length. A malformed
+// sequence gives U+FFFD for its first byte.
+uint32_t next_code_point(const unsigned char* p, size_t n, size_t& len) {
+    static constexpr uint32_t min_code_point[] = {0, 0, 0x80, 0x800, 0x10000};
+    unsigned char c = p[0];
+    len = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+    if (len == 1 || len > n) { len = 1; return 0xfffd; }
+    uint32_t cp = c & (0x3f >> (len - 1));
+    for (size_t k = 1; k < len; ++k) {
+        if ((p[k] & 0xc0) != 0x80) { len = 1; return 0xfffd; }
+        cp = (cp << 6) | (p[k] & 0x3f);
+    }
+    if (cp < min_code_point[len] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) { len = 1; return 0xfffd; }
+    return cp;
+}
+
+// write_string with everything outside ASCII escaped
+void write_ascii_string(std::string& out, std::string_view s) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    const unsigned char* end = p + s.size();
+    out.push_back('"');
+    while (p < end) {
+        const unsigned char* run = p;
+        while (p < end && *p < 0x80 && !escape_table.needs[*p]) ++p;
+        out.append(reinterpret_cast<const char*>(run), p - run);
+        if (p == end) break;
+        if (*p < 0x80) {
+            append_escape(out, static_cast<char>(*p++));
+            continue;
+        }
+        size_t len;
+        uint32_t cp = next_code_point(p, end - p, len);
+        p += len;
+        if (cp < 0x10000) {
+            append_u16(out, cp);
+        } else {
+            cp -= 0x10000;
+            append_u16(out, 0xd800 + (cp >> 10));
+            append_u16(out, 0xdc00 + (cp & 0x3ff));
+        }
+    }
+    out.push_back('"');
+}
+
+void write_double_precision(std::string& out, double d, int precision) {
+    if (!std::isfinite(d)) { out.append("null", 4); return; }
+    char buf[40];
+    auto res = std::to_chars(buf, buf + sizeof(buf), d, std::chars_format::general, std::min(precision, 17));
+    out.append(buf, res.ptr - buf);
+    for (const char* p = buf; p < res.ptr; ++p) {
+        if (*p == '.' || *p == 'e') return;
+    }
+    out.append(".0", 2);
+}
+
+// Number::prototype.toString from ECMAScript, which RFC 8785 adopts: the
+// shortest round-trip digits, plain notation from 1e-6 up to 1e21
+void write_canonical_double(std::string& out, double d) {
+    if (!std::isfinite(d)) throw std::runtime_error("NaN and infinity have no canonical JSON form");
+    if (d == 0) { out.push_back('0'); return; }
+    if (d < 0) { out.push_back('-'); d = -d; }
+
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), d, std::chars_format::scientific);
+    char digits[20];
+    int k = 0;
+    const char* p = buf;
+    for (; *p != 'e'; ++p) {
+        if (*p != '.') digits[k++] = *p;
+    }
+    ++p;
+    if (*p == '+') ++p;
+    int exponent = 0;
+    std::from_chars(p, res.ptr, exponent);
+
+    int n = exponent + 1; // digits before the decimal point
+    if (k <= n && n <= 21) {
+        out.append(digits, k);
+        out.append(n - k, '0');
+    } else if (0 < n && n <= 21) {
+        out.append(digits, n);
+        out.push_back('.');
+        out.append(digits + n, k - n);
+    } else if (-6 < n && n <= 0) {
+        out.append("0.", 2);
+        out.append(-n, '0');
+        out.append(digits, k);
+    } else {
+        out.push_back(digits[0]);
+        if (k > 1) {
+            out.push_back('.');
+            out.append(digits + 1, k - 1);
+        }
+        out.push_back('e');
+        out.push_back(n - 1 < 0 ? '-' : '+');
+        write_int(out, std::abs(n - 1));
     }
-    oss << "}";
-    return oss.str();
+}
+
+// Rank of the first differing byte of two UTF-8 keys, ordering them by
+// UTF-16 code units: code point order, except that characters above
+// U+FFFF (surrogates D800-DFFF) come before U+E000-U+FFFF
+unsigned utf16_rank(unsigned char c) {
+    return c >= 0xf0 ? 0xed * 16 + 8 + (c - 0xf0) : c * 16u;
+}
+
+bool utf16_less(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) ++i;
+    if (i == n) return a.size() < b.size();
+    return utf16_rank(static_cast<unsigned char>(a[i])) < utf16_rank(static_cast<unsigned char>(b[i]));
+}
+
+// Serializes with options. The layout is a template parameter, so single
+// line output carries no indentation checks; the rest is read at run time.
+template <bool Pretty>
+class Printer {
+public:
+    Printer(std::string& out, const SerializeOptions& options) : out(out), options(options) {}
+
+    void value(const Value& v) {
+        switch (v.data.index()) {
+            case 0: out.append("null", 4); break;
+            case 1: std::get<bool>(v.data) ? out.append("true", 4) : out.append("false", 5); break;
+            case 2: integer(std::get<int64_t>(v.data)); break;
+            case 3: integer(std::get<uint64_t>(v.data)); break;
+            case 4: number(std::get<double>(v.data)); break;
+            case 5: string(std::get<std::string>(v.data)); break;
+            case 6: array(std::get<Array>(v.data)); break;
+            case 7: object(std::get<Object>(v.data)); break;
+        }
+    }
+
+private:
+    void newline() {
+        if constexpr (Pretty) {
+            out.push_back('\n');
+            out.append(depth * options.indent, ' ');
+        }
+    }
+
+    template <class T>
+    void integer(T i) {
+        // JCS numbers are doubles, only integers a double holds exactly
+        // keep their digits
+        constexpr T exact = T(1) << 53;
+        if (options.canonical && (i > exact || (std::is_signed_v<T> && i < -exact))) {
+            write_canonical_double(out, static_cast<double>(i));
+        } else if constexpr (std::is_signed_v<T>) {
+            write_int(out, i);
+        } else {
+            write_uint(out, i);
+        }
+    }
+
+    void number(double d) {
+        if (options.canonical) {
+            write_canonical_double(out, d);
+        } else if (options.precision > 0) {
+            write_double_precision(out, d, options.precision);
+        } else {
+            write_double(out, d);
+        }
+    }
+
+    void string(std::string_view s) {
+        if (options.ascii_only) {
+            write_ascii_string(out, s);
+        } else {
+            write_string(out, s);
+        }
+    }
+
+    void array(const Array& a) {
+        out.push_back('[');
+        if (!a.empty()) {
+            ++depth;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (i) out.push_back(',');
+                newline();
+                value(a[i]);
+            }
+            --depth;
+            newline();
+        }
+        out.push_back(']');
+    }
+
+    void member(std::string_view key, const Value& v) {
+        newline();
+        string(key);
+        out.push_back(':');
+        if constexpr (Pretty) out.push_back(' ');
+        value(v);
+    }
+
+    void object(const Object& o) {
+        out.push_back('{');
+        if (!o.empty()) {
+            ++depth;
+            if (options.sort_keys) {
+                std::vector<std::pair<std::string_view, const Value*>> members;
+                members.reserve(o.size());
+                for (const auto& [key, val] : o) members.emplace_back(key, &val);
+                if (options.canonical) {
+                    std::sort(members.begin(), members.end(), [](const auto& a, const auto& b) { return utf16_less(a.first, b.first); });
+                } else {
+                    std::sort(members.begin(), members.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                }
+                for (size_t i = 0; i < members.size(); ++i) {
+                    if (i) out.push_back(',');
+                    member(members[i].first, *members[i].second);
+                }
+            } else {
+                bool first = true;
+                for (const auto& [key, val] : o) {
+                    if (!first) out.push_back(',');
+                    first = false;
+                    member(key, val);
+                }
+            }
+            --depth;
+            newline();
+        }
+        out.push_back('}');
+    }
+
+    std::string& out;
+    const SerializeOptions& options;
+    size_t depth = 0;
+};
+
+void write_value(std::string& out, const Value& v, const SerializeOptions& options) {
+    if (options.canonical) {
+        SerializeOptions jcs;
+        jcs.sort_keys = true;
+        jcs.canonical = true;
+        Printer<false>(out, jcs).value(v);
+    } else if (options.indent) {
+        Printer<true>(out, options).value(v);
+    } else if (options.sort_keys || options.ascii_only || options.precision > 0) {
+        Printer<false>(out, options).value(v);
+    } else {
+        write_value(out, v);
+    }
+}
+
+} // namespace
+
+void Writer::write(const Value& v) {
+    JSONN_STATS_SCOPE("Writer::write", serialize);
+    [[maybe_unused]] size_t before = buf.size();
+    write_value(buf, v);
+    JSONN_STAT(st->bytes_serialized += buf.size() - before);
+}
+
+void Writer::write(const Value& v, const SerializeOptions& options) {
+    JSONN_STATS_SCOPE("Writer::write", serialize);
+    [[maybe_unused]] size_t before = buf.size();
+    write_value(buf, v, options);
+    JSONN_STAT(st->bytes_serialized += buf.size() - before);
+}
+
+void serialize_to(std::string& out, const Value& v) {
+    JSONN_STATS_SCOPE("serialize_to", serialize);
+    [[maybe_unused]] size_t before = out.size();
+    write_value(out, v);
+    JSONN_STAT(st->bytes_serialized += out.size() - before);
 }
 
 // Serialize Value
 std::string serialize(const Value& v) {
-    if (v.is_null()) return "null";
-    if (v.is_bool()) return v.as_bool() ? "true" : "false";
-    if (v.is_number()) return std::to_string(v.as_number());
-    if (v.is_string()) return "\"" + v.as_string() + "\"";
-    if (v.is_array()) return serialize(v.as_array());
-    if (v.is_object()) return serialize(v.as_object());
-    return "null";
+    JSONN_STATS_SCOPE("serialize", serialize);
+    std::string out;
+    write_value(out, v);
+    JSONN_STAT(st->bytes_serialized += out.size());
+    return out;
+}
+
+void serialize_to(std::string& out, const Value& v, const SerializeOptions& options) {
+    JSONN_STATS_SCOPE("serialize_to", serialize);
+    [[maybe_unused]] size_t before = out.size();
+    write_value(out, v, options);
+    JSONN_STAT(st->bytes_serialized += out.size() - before);
+}
+
+std::string serialize(const Value& v, const SerializeOptions& options) {
+    JSONN_STATS_SCOPE("serialize", serialize);
+    std::string out;
+    write_value(out, v, options);
+    JSONN_STAT(st->bytes_serialized += out.size());
+    return out;
 }
 
 } // namespace jsonn
@@ -30,34 +30,93 @@
 */
 
 #include "jsonn.h"
-#include <exception>
-#include <sstream>
+#include "jsonn_parallel.h"
+#include "jsonn_stats.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
 #include <vector>
-#include <mutex>
-#include <thread>
-#include <algorithm>
 
 namespace jsonn {
-   __attribute__((visibility("default"))) std::string serialize_jsonl(const std::vector<Value>& v) {
-      std::vector<std::string> lines;
 
-      for (size_t i = 0; i < v.size(); i++) {
-         std::string s = jsonn::serialize(v[i]);
+namespace {
 
-         s.erase(
-         std::remove_if(s.begin(), s.end(),
-                           [](unsigned char c) { return std::isspace(c); }),
-          s.end()
-        );
+// Serial output is handed to the sink in pieces of about this size
+constexpr size_t flush_size = 1 << 20;
 
-        lines.push_back(std::move(s));
+void write_all(int fd, std::string_view s) {
+    while (!s.empty()) {
+        ssize_t n = ::write(fd, s.data(), s.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Write failed: ") + std::strerror(errno));
+        }
+        s.remove_prefix(static_cast<size_t>(n));
     }
+}
+
+} // namespace
 
-    std::ostringstream oss;
-    for (const auto& line : lines) {
-        oss << line << '\n';
+// Records are serialized in batches, a window of batches at a time: every
+// batch gets its own buffer on whichever thread runs it, and the buffers
+// go to the sink in order before the next window starts. Buffers are
+// reused, so memory stays at one window of output.
+__attribute__((visibility("default")))
+void serialize_jsonl_to(const Sink& sink, const std::vector<Value>& v, const ParallelOptions& options) {
+    JSONN_STATS_SCOPE("serialize_jsonl", serialize);
+    if (v.size() < options.serial_records) {
+        std::string buf;
+        for (const Value& value : v) {
+            serialize_to(buf, value);
+            buf.push_back('\n');
+            if (buf.size() >= flush_size) {
+                sink(buf);
+                buf.clear();
+            }
+        }
+        if (!buf.empty()) sink(buf);
+        return;
     }
 
-    return oss.str();
+    size_t workers = detail::parallelism(options);
+    size_t per_batch = options.batch_records ? options.batch_records
+                                             : std::clamp<size_t>(v.size() / (workers * 8), 256, 16384);
+    size_t batches = (v.size() + per_batch - 1) / per_batch;
+    size_t window = std::min(batches, workers * 2);
+    std::vector<std::string> buffers(window);
+    detail::StatsCall* call = JSONN_STATS_CALL();
+    JSONN_STAT(st->threads = static_cast<uint32_t>(workers));
+
+    for (size_t first = 0; first < batches; first += window) {
+        size_t count = std::min(window, batches - first);
+        JSONN_STATS_TIMER(parallel_start);
+        detail::run_parallel(options, count, [&](size_t k) {
+            JSONN_STATS_TASK(call);
+            std::string& buf = buffers[k];
+            buf.clear();
+            size_t begin = (first + k) * per_batch;
+            size_t end = std::min(begin + per_batch, v.size());
+            for (size_t i = begin; i < end; ++i) {
+                serialize_to(buf, v[i]);
+                buf.push_back('\n');
+            }
+        });
+        JSONN_STAT(st->parallel_time += JSONN_STATS_ELAPSED(parallel_start));
+        for (size_t k = 0; k < count; ++k) sink(buffers[k]);
+    }
 }
-}
\ No newline at end of file
+
+__attribute__((visibility("default")))
+void serialize_jsonl_to(int fd, const std::vector<Value>& v, const ParallelOptions& options) {
+    serialize_jsonl_to([fd](std::string_view s) { write_all(fd, s); }, v, options);
+}
+
+__attribute__((visibility("default")))
+std::string serialize_jsonl(const std::vector<Value>& v, const ParallelOptions& options) {
+    std::string out;
+    serialize_jsonl_to([&out](std::string_view s) { out.append(s); }, v, options);
+    return out;
+}
+
+} // namespace jsonn
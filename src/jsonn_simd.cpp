@@ -0,0 +1,324 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn_simd.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JSONN_X86 1
+#endif
+
+namespace jsonn::detail {
+
+namespace {
+
+#define JSONN_INLINE inline __attribute__((always_inline))
+
+// Carried from one 64-byte block to the next
+struct ScanState {
+    uint64_t prev_odd_backslash = 0;   // block ended in an odd run of backslashes
+    uint64_t prev_in_string = 0;       // all ones if block ended inside a string
+    uint64_t prev_pseudo_pred = 1;     // start of input counts as whitespace
+};
+
+struct BlockMasks {
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t whitespace;
+    uint64_t op;
+};
+
+// Quotes that aren't preceded by an odd run of backslashes
+JSONN_INLINE uint64_t unescaped_quotes(const BlockMasks& m, ScanState& st) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    const uint64_t odd_bits = ~even_bits;
+    uint64_t bs = m.backslash;
+    uint64_t start_edges = bs & ~(bs << 1);
+    uint64_t even_start_mask = even_bits ^ st.prev_odd_backslash;
+    uint64_t even_starts = start_edges & even_start_mask;
+    uint64_t odd_starts = start_edges & ~even_start_mask;
+    uint64_t even_carries = bs + even_starts;
+    uint64_t odd_carries;
+    bool ends_odd = __builtin_add_overflow(bs, odd_starts, &odd_carries);
+    odd_carries |= st.prev_odd_backslash;
+    st.prev_odd_backslash = ends_odd ? 1 : 0;
+    uint64_t even_carry_ends = even_carries & ~bs;
+    uint64_t odd_carry_ends = odd_carries & ~bs;
+    uint64_t odd_ends = (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+    return m.quote & ~odd_ends;
+}
+
+// in_string is the prefix xor of the unescaped quotes: set from an opening
+// quote up to, but not including, its closing quote
+JSONN_INLINE uint64_t structurals(const BlockMasks& m, uint64_t quotes, uint64_t in_string, ScanState& st) {
+    in_string ^= st.prev_in_string;
+    st.prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+    uint64_t s = (m.op & ~in_string) | quotes;
+    uint64_t pseudo_pred = s | m.whitespace;
+    uint64_t shifted = (pseudo_pred << 1) | st.prev_pseudo_pred;
+    st.prev_pseudo_pred = pseudo_pred >> 63;
+    s |= shifted & ~m.whitespace & ~in_string;
+    return s & ~(quotes & ~in_string); // drop closing quotes
+}
+
+JSONN_INLINE uint64_t prefix_xor_scalar(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+JSONN_INLINE void flatten(std::vector<uint32_t>& out, uint32_t base, uint64_t bits) {
+    while (bits) {
+        out.push_back(base + static_cast<uint32_t>(__builtin_ctzll(bits)));
+        bits &= bits - 1;
+    }
+}
+
+// Inside a string at the end, the last entry is its opening quote, which
+// is where the parsers report an unterminated string too
+void check_closed(const ScanState& st, const std::vector<uint32_t>& out) {
+    if (st.prev_in_string) {
+        throw std::runtime_error("Unterminated string at position " + std::to_string(out.empty() ? 0 : out.back()));
+    }
+}
+
+// Scalar kernel
+
+enum : uint8_t { C_WS = 1, C_OP = 2, C_QUOTE = 4, C_BACKSLASH = 8 };
+
+struct ClassTable {
+    uint8_t cls[256] = {};
+    constexpr ClassTable() {
+        cls[static_cast<unsigned char>(' ')] = C_WS;
+        cls[static_cast<unsigned char>('\t')] = C_WS;
+        cls[static_cast<unsigned char>('\n')] = C_WS;
+        cls[static_cast<unsigned char>('\r')] = C_WS;
+        for (char c : {'{', '}', '[', ']', ':', ','}) cls[static_cast<unsigned char>(c)] = C_OP;
+        cls[static_cast<unsigned char>('"')] = C_QUOTE;
+        cls[static_cast<unsigned char>('\\')] = C_BACKSLASH;
+    }
+};
+constexpr ClassTable class_table;
+
+BlockMasks classify_scalar(const char* p) {
+    BlockMasks m{0, 0, 0, 0};
+    for (int i = 0; i < 64; ++i) {
+        uint8_t c = class_table.cls[static_cast<unsigned char>(p[i])];
+        uint64_t bit = uint64_t(1) << i;
+        if (c & C_WS) m.whitespace |= bit;
+        if (c & C_OP) m.op |= bit;
+        if (c & C_QUOTE) m.quote |= bit;
+        if (c & C_BACKSLASH) m.backslash |= bit;
+    }
+    return m;
+}
+
+void index_scalar(const char* data, size_t len, std::vector<uint32_t>& out) {
+    ScanState st;
+    char tail[64];
+    for (size_t i = 0; i < len; i += 64) {
+        const char* p = data + i;
+        if (len - i < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, len - i);
+            p = tail;
+        }
+        BlockMasks m = classify_scalar(p);
+        uint64_t quotes = unescaped_quotes(m, st);
+        uint64_t bits = structurals(m, quotes, prefix_xor_scalar(quotes), st);
+        flatten(out, static_cast<uint32_t>(i), bits);
+    }
+    check_closed(st, out);
+}
+
+#ifdef JSONN_X86
+
+// SSE4.2 kernel, four 16-byte lanes per block
+
+__attribute__((target("sse4.2,pclmul"))) inline uint64_t prefix_xor_clmul(uint64_t x) {
+    __m128i all_ones = _mm_set1_epi8(static_cast<char>(0xff));
+    __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(x)), all_ones, 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(r));
+}
+
+__attribute__((target("sse4.2"))) inline uint64_t movemask_sse(__m128i a, __m128i b, __m128i c, __m128i d) {
+    uint64_t r0 = static_cast<uint32_t>(_mm_movemask_epi8(a));
+    uint64_t r1 = static_cast<uint32_t>(_mm_movemask_epi8(b));
+    uint64_t r2 = static_cast<uint32_t>(_mm_movemask_epi8(c));
+    uint64_t r3 = static_cast<uint32_t>(_mm_movemask_epi8(d));
+    return r0 | (r1 << 16) | (r2 << 32) | (r3 << 48);
+}
+
+__attribute__((target("sse4.2"))) inline __m128i eq_sse(__m128i v, char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+__attribute__((target("sse4.2"))) inline void classify_lane_sse(__m128i v, __m128i& bs, __m128i& q, __m128i& ws, __m128i& op) {
+    bs = eq_sse(v, '\\');
+    q = eq_sse(v, '"');
+    ws = _mm_or_si128(_mm_or_si128(eq_sse(v, ' '), eq_sse(v, '\t')),
+                      _mm_or_si128(eq_sse(v, '\n'), eq_sse(v, '\r')));
+    op = _mm_or_si128(_mm_or_si128(_mm_or_si128(eq_sse(v, '{'), eq_sse(v, '}')),
+                                   _mm_or_si128(eq_sse(v, '['), eq_sse(v, ']'))),
+                      _mm_or_si128(eq_sse(v, ':'), eq_sse(v, ',')));
+}
+
+__attribute__((target("sse4.2"))) inline BlockMasks classify_sse(const char* p) {
+    __m128i bs[4], q[4], ws[4], op[4];
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        classify_lane_sse(v, bs[i], q[i], ws[i], op[i]);
+    }
+    return BlockMasks{
+        movemask_sse(bs[0], bs[1], bs[2], bs[3]),
+        movemask_sse(q[0], q[1], q[2], q[3]),
+        movemask_sse(ws[0], ws[1], ws[2], ws[3]),
+        movemask_sse(op[0], op[1], op[2], op[3]),
+    };
+}
+
+__attribute__((target("sse4.2,pclmul"))) void index_sse42(const char* data, size_t len, std::vector<uint32_t>& out) {
+    ScanState st;
+    char tail[64];
+    for (size_t i = 0; i < len; i += 64) {
+        const char* p = data + i;
+        if (len - i < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, len - i);
+            p = tail;
+        }
+        BlockMasks m = classify_sse(p);
+        uint64_t quotes = unescaped_quotes(m, st);
+        uint64_t bits = structurals(m, quotes, prefix_xor_clmul(quotes), st);
+        flatten(out, static_cast<uint32_t>(i), bits);
+    }
+    check_closed(st, out);
+}
+
+// AVX2 kernel, two 32-byte lanes per block
+
+__attribute__((target("avx2"))) inline __m256i eq_avx2(__m256i v, char c) {
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) inline uint64_t movemask_avx2(__m256i lo, __m256i hi) {
+    uint64_t r0 = static_cast<uint32_t>(_mm256_movemask_epi8(lo));
+    uint64_t r1 = static_cast<uint32_t>(_mm256_movemask_epi8(hi));
+    return r0 | (r1 << 32);
+}
+
+__attribute__((target("avx2"))) inline void classify_lane_avx2(__m256i v, __m256i& bs, __m256i& q, __m256i& ws, __m256i& op) {
+    bs = eq_avx2(v, '\\');
+    q = eq_avx2(v, '"');
+    ws = _mm256_or_si256(_mm256_or_si256(eq_avx2(v, ' '), eq_avx2(v, '\t')),
+                         _mm256_or_si256(eq_avx2(v, '\n'), eq_avx2(v, '\r')));
+    op = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(eq_avx2(v, '{'), eq_avx2(v, '}')),
+                                         _mm256_or_si256(eq_avx2(v, '['), eq_avx2(v, ']'))),
+                         _mm256_or_si256(eq_avx2(v, ':'), eq_avx2(v, ',')));
+}
+
+__attribute__((target("avx2"))) inline BlockMasks classify_avx2(const char* p) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    __m256i bs[2], q[2], ws[2], op[2];
+    classify_lane_avx2(lo, bs[0], q[0], ws[0], op[0]);
+    classify_lane_avx2(hi, bs[1], q[1], ws[1], op[1]);
+    return BlockMasks{
+        movemask_avx2(bs[0], bs[1]),
+        movemask_avx2(q[0], q[1]),
+        movemask_avx2(ws[0], ws[1]),
+        movemask_avx2(op[0], op[1]),
+    };
+}
+
+__attribute__((target("avx2,pclmul"))) void index_avx2(const char* data, size_t len, std::vector<uint32_t>& out) {
+    ScanState st;
+    char tail[64];
+    for (size_t i = 0; i < len; i += 64) {
+        const char* p = data + i;
+        if (len - i < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, len - i);
+            p = tail;
+        }
+        BlockMasks m = classify_avx2(p);
+        uint64_t quotes = unescaped_quotes(m, st);
+        uint64_t bits = structurals(m, quotes, prefix_xor_clmul(quotes), st);
+        flatten(out, static_cast<uint32_t>(i), bits);
+    }
+    check_closed(st, out);
+}
+
+#endif // JSONN_X86
+
+} // namespace
+
+Kernel best_kernel() {
+    static const Kernel kernel = [] {
+#ifdef JSONN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("pclmul")) return Kernel::avx2;
+        if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul")) return Kernel::sse42;
+#endif
+        return Kernel::scalar;
+    }();
+    return kernel;
+}
+
+const char* kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::avx2: return "avx2";
+        case Kernel::sse42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+void build_structural_index(const char* data, size_t len, std::vector<uint32_t>& out, Kernel kernel) {
+    // Rough guess of one token per four bytes saves most regrowth
+    out.reserve(out.size() + len / 4 + 16);
+    switch (kernel) {
+#ifdef JSONN_X86
+        case Kernel::avx2: index_avx2(data, len, out); return;
+        case Kernel::sse42: index_sse42(data, len, out); return;
+#endif
+        default: index_scalar(data, len, out); return;
+    }
+}
+
+} // namespace jsonn::detail
@@ -0,0 +1,155 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "jsonn_stats.h"
+#include <algorithm>
+#include <mutex>
+
+namespace jsonn {
+
+namespace {
+
+std::mutex stats_mutex;
+Stats total_stats;
+StatsHook stats_hook;
+
+} // namespace
+
+Stats& Stats::operator+=(const Stats& o) {
+    calls += o.calls;
+    bytes_parsed += o.bytes_parsed;
+    bytes_serialized += o.bytes_serialized;
+    nulls += o.nulls;
+    bools += o.bools;
+    integers += o.integers;
+    doubles += o.doubles;
+    strings += o.strings;
+    arrays += o.arrays;
+    objects += o.objects;
+    max_depth = std::max(max_depth, o.max_depth);
+    allocations += o.allocations;
+    allocated_bytes += o.allocated_bytes;
+    parse_time += o.parse_time;
+    serialize_time += o.serialize_time;
+    split_time += o.split_time;
+    parallel_time += o.parallel_time;
+    task_time += o.task_time;
+    max_task_time = std::max(max_task_time, o.max_task_time);
+    merge_time += o.merge_time;
+    tasks += o.tasks;
+    threads = std::max(threads, o.threads);
+    return *this;
+}
+
+bool stats_enabled() {
+    return JSONN_STATS;
+}
+
+Stats stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return total_stats;
+}
+
+void reset_stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    total_stats = Stats();
+}
+
+void set_stats_hook(StatsHook hook) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats_hook = std::move(hook);
+}
+
+#if JSONN_STATS
+
+namespace detail {
+
+thread_local Stats* current_stats = nullptr;
+thread_local StatsCall* current_call = nullptr;
+
+StatsScope::StatsScope(const char* api, Phase phase)
+    : api(api), phase(phase), owner(current_stats == nullptr), start(StatsClock::now()) {
+    if (owner) {
+        local.stats.calls = 1;
+        current_stats = &local.stats;
+        current_call = &local;
+    }
+}
+
+StatsScope::~StatsScope() {
+    if (!owner) return;
+    current_stats = nullptr;
+    current_call = nullptr;
+    // Every task has merged by now, the call's lock is free
+    Stats& s = local.stats;
+    double elapsed = seconds_since(start);
+    if (phase == parse) s.parse_time += elapsed;
+    if (phase == serialize) s.serialize_time += elapsed;
+
+    StatsHook hook;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        total_stats += s;
+        hook = stats_hook;
+    }
+    if (hook) hook(api, s);
+}
+
+StatsTask::StatsTask(StatsCall* call)
+    : call(call), prev(current_stats), prev_call(current_call), start(StatsClock::now()) {
+    if (call) {
+        current_stats = &local.stats;
+        current_call = &local;
+    }
+}
+
+StatsTask::~StatsTask() {
+    if (!call) return;
+    current_stats = prev;
+    current_call = prev_call;
+    Stats& s = local.stats;
+    double elapsed = seconds_since(start);
+    s.task_time += elapsed;
+    s.max_task_time = elapsed;
+    s.tasks = 1;
+    // Per-task time is already in task_time, the call's wall time covers it
+    s.parse_time = 0;
+    s.serialize_time = 0;
+    std::lock_guard<std::mutex> lock(call->merge);
+    call->stats += s;
+}
+
+} // namespace detail
+
+#endif
+
+} // namespace jsonn
@@ -0,0 +1,128 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+#include "jsonn.h"
+
+// Instrumentation hooks. With JSONN_STATS off every macro expands to
+// nothing, so the default build pays no cost.
+#ifndef JSONN_STATS
+#define JSONN_STATS 0
+#endif
+
+namespace jsonn::detail {
+struct StatsCall;
+} // namespace jsonn::detail
+
+#if JSONN_STATS
+#include <chrono>
+#include <mutex>
+
+namespace jsonn::detail {
+
+// Counters of a call that tasks on other threads add to; the lock is only
+// taken for those merges, so calls on different threads never contend.
+struct StatsCall {
+    Stats stats;
+    std::mutex merge;
+};
+
+// Counters of the call running on this thread, null outside of one
+extern thread_local Stats* current_stats;
+// The same counters with their lock, handed to the call's tasks
+extern thread_local StatsCall* current_call;
+
+using StatsClock = std::chrono::steady_clock;
+
+inline double seconds_since(StatsClock::time_point start) {
+    return std::chrono::duration<double>(StatsClock::now() - start).count();
+}
+
+// Wraps a public API call. The outermost scope on a thread owns the
+// counters, publishes them when it ends and calls the hook; scopes nested
+// in it (parse() inside parse_jsonl()) only add to them.
+class StatsScope {
+public:
+    enum Phase { parse, serialize, none };
+
+    StatsScope(const char* api, Phase phase);
+    ~StatsScope();
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+    Stats* get() { return current_stats; }
+
+private:
+    const char* api;
+    Phase phase;
+    bool owner;
+    StatsCall local;
+    StatsClock::time_point start;
+};
+
+// One task of a parallel call, run on a pool thread. Its counters are added
+// to the call's under the call's lock when it ends.
+class StatsTask {
+public:
+    explicit StatsTask(StatsCall* call);
+    ~StatsTask();
+    StatsTask(const StatsTask&) = delete;
+    StatsTask& operator=(const StatsTask&) = delete;
+
+private:
+    StatsCall* call;
+    Stats* prev;
+    StatsCall* prev_call;
+    StatsCall local;
+    StatsClock::time_point start;
+};
+
+} // namespace jsonn::detail
+
+#define JSONN_STATS_SCOPE(api, phase) ::jsonn::detail::StatsScope jsonn_stats_scope(api, ::jsonn::detail::StatsScope::phase)
+// Runs stmt with st pointing at the current counters, if there are any
+#define JSONN_STAT(stmt) do { if (::jsonn::Stats* st = ::jsonn::detail::current_stats) { stmt; } } while (0)
+#define JSONN_STATS_CALL() (::jsonn::detail::current_call)
+#define JSONN_STATS_TASK(call) ::jsonn::detail::StatsTask jsonn_stats_task(call)
+#define JSONN_STATS_TIMER(name) auto name = ::jsonn::detail::StatsClock::now()
+#define JSONN_STATS_ELAPSED(name) ::jsonn::detail::seconds_since(name)
+
+#else
+
+#define JSONN_STATS_SCOPE(api, phase) do {} while (0)
+#define JSONN_STAT(stmt) do {} while (0)
+#define JSONN_STATS_CALL() (static_cast<::jsonn::detail::StatsCall*>(nullptr))
+#define JSONN_STATS_TASK(call) do { (void)(call); } while (0)
+#define JSONN_STATS_TIMER(name) do {} while (0)
+#define JSONN_STATS_ELAPSED(name) 0.0
+
+#endif
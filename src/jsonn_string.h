@@ -0,0 +1,256 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace jsonn::detail {
+
+inline bool is_string_special(char c) {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+// Position of the first '"', '\\' or raw control character at or after
+// pos, or len if there is none
+inline size_t find_string_special(const char* str, size_t len, size_t pos) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+    for (; len - pos >= 16; pos += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+        // min(v, 0x1f) == v for the bytes below 0x20
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) return pos + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+#else
+    // SWAR: a byte of v ^ c is zero where v holds c, and v - 0x20 borrows
+    // into the high bit of bytes below 0x20
+    constexpr uint64_t ones = 0x0101010101010101ULL;
+    constexpr uint64_t highs = 0x8080808080808080ULL;
+    for (; len - pos >= 8; pos += 8) {
+        uint64_t v;
+        std::memcpy(&v, str + pos, 8);
+        uint64_t q = v ^ (ones * '"');
+        uint64_t b = v ^ (ones * '\\');
+        uint64_t hits = (((q - ones) & ~q) | ((b - ones) & ~b) | ((v - ones * 0x20) & ~v)) & highs;
+        if (hits) break;
+    }
+#endif
+    while (pos < len && !is_string_special(str[pos])) ++pos;
+    return pos;
+}
+
+// Checks that [begin, begin + n) is well-formed UTF-8: no overlong forms,
+// surrogates or code points above U+10FFFF. ASCII is skipped a word at a
+// time. Returns the offset of the first bad byte, or n if there is none.
+inline size_t find_invalid_utf8(const char* begin, size_t n) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(begin);
+    size_t i = 0;
+    while (i < n) {
+        if (n - i >= 8) {
+            uint64_t v;
+            std::memcpy(&v, s + i, 8);
+            if (!(v & 0x8080808080808080ULL)) { i += 8; continue; }
+        }
+        unsigned char c = s[i];
+        if (c < 0x80) { ++i; continue; }
+
+        size_t extra;
+        unsigned char lo = 0x80, hi = 0xBF; // allowed range of the second byte
+        if (c >= 0xC2 && c <= 0xDF) {
+            extra = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            extra = 2;
+            if (c == 0xE0) lo = 0xA0;      // overlong
+            else if (c == 0xED) hi = 0x9F; // surrogates
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            extra = 3;
+            if (c == 0xF0) lo = 0x90;      // overlong
+            else if (c == 0xF4) hi = 0x8F; // above U+10FFFF
+        } else {
+            return i;
+        }
+        if (n - i <= extra || s[i + 1] < lo || s[i + 1] > hi) return i;
+        for (size_t k = 2; k <= extra; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) return i;
+        }
+        i += extra + 1;
+    }
+    return n;
+}
+
+inline void check_utf8(const char* str, size_t begin, size_t end, size_t base) {
+    size_t bad = find_invalid_utf8(str + begin, end - begin);
+    if (bad != end - begin) throw std::runtime_error("Invalid UTF-8 at position " + std::to_string(base + begin + bad));
+}
+
+inline void append_utf8(std::string& out, uint32_t cp) {
+    char buf[4];
+    size_t n;
+    if (cp < 0x80) {
+        buf[0] = static_cast<char>(cp);
+        n = 1;
+    } else if (cp < 0x800) {
+        buf[0] = static_cast<char>(0xC0 | (cp >> 6));
+        buf[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        buf[0] = static_cast<char>(0xE0 | (cp >> 12));
+        buf[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = static_cast<char>(0xF0 | (cp >> 18));
+        buf[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    out.append(buf, n);
+}
+
+// Reported at the opening quote, as the structural index does
+[[noreturn]] inline void throw_unterminated(size_t open, size_t base) {
+    throw std::runtime_error("Unterminated string at position " + std::to_string(base + open));
+}
+
+// RFC 8259 wants control characters escaped. One is only reported once
+// the string is known to end, so a string cut off after it is reported as
+// unterminated, as the structural index does.
+[[noreturn]] inline void throw_control(const char* str, size_t len, size_t open, size_t pos, size_t base) {
+    for (size_t i = pos; i < len; ++i) {
+        if (str[i] == '\\') {
+            ++i;
+        } else if (str[i] == '"') {
+            throw std::runtime_error("Unescaped control character at position " + std::to_string(base + pos));
+        }
+    }
+    throw_unterminated(open, base);
+}
+
+// Reads the four hex digits of a \u escape at pos
+inline uint32_t read_hex4(const char* str, size_t len, size_t pos, size_t base) {
+    unsigned int hex = 0;
+    auto res = len - pos >= 4 ? std::from_chars(str + pos, str + pos + 4, hex, 16) : std::from_chars_result{str + pos, std::errc::invalid_argument};
+    if (res.ptr != str + pos + 4) throw std::runtime_error("Invalid unicode escape at position " + std::to_string(base + pos));
+    return hex;
+}
+
+// Decodes escapes from pos (inside a string body) up to and including the
+// closing quote, appending to out. Runs without escapes are appended in one
+// go. Returns the position after the closing quote.
+inline size_t decode_escapes(const char* str, size_t len, size_t pos, std::string& out, bool validate, size_t base) {
+    size_t open = pos - 1;
+    while (true) {
+        size_t run = pos;
+        pos = find_string_special(str, len, pos);
+        if (pos >= len) throw_unterminated(open, base);
+        if (validate) check_utf8(str, run, pos, base);
+        out.append(str + run, pos - run);
+        if (str[pos] != '"' && str[pos] != '\\') throw_control(str, len, open, pos, base);
+        if (str[pos++] == '"') return pos;
+
+        if (pos >= len) throw_unterminated(open, base);
+        char esc = str[pos++];
+        switch (esc) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'u': {
+                uint32_t cp = read_hex4(str, len, pos, base);
+                pos += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate, must be followed by an escaped low one
+                    if (len - pos < 2 || str[pos] != '\\' || str[pos + 1] != 'u') {
+                        throw std::runtime_error("Unpaired surrogate at position " + std::to_string(base + pos - 6));
+                    }
+                    uint32_t low = read_hex4(str, len, pos + 2, base);
+                    if (low < 0xDC00 || low > 0xDFFF) throw std::runtime_error("Unpaired surrogate at position " + std::to_string(base + pos - 6));
+                    pos += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    throw std::runtime_error("Unpaired surrogate at position " + std::to_string(base + pos - 6));
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown escape character: \\" + std::string(1, esc) + " at position " + std::to_string(base + pos));
+        }
+    }
+}
+
+// Scans the string body starting at pos (just past the opening quote) and
+// returns the position after the closing quote. A string without escapes
+// comes back as a view into str; otherwise it is decoded into scratch and
+// the view points there. base is added to positions in error messages when
+// str is a slice of the input.
+inline size_t scan_string(const char* str, size_t len, size_t pos, std::string_view& out, std::string& scratch,
+                          bool validate = true, size_t base = 0) {
+    size_t begin = pos;
+    pos = find_string_special(str, len, pos);
+    if (pos >= len) throw_unterminated(begin - 1, base);
+    if (str[pos] == '"') {
+        if (validate) check_utf8(str, begin, pos, base);
+        out = std::string_view(str + begin, pos - begin);
+        return pos + 1;
+    }
+    scratch.clear();
+    pos = decode_escapes(str, len, begin, scratch, validate, base);
+    out = scratch;
+    return pos;
+}
+
+// Decodes the string body starting at pos (just past the opening quote)
+// into out and returns the position after the closing quote
+inline size_t decode_string(const char* str, size_t len, size_t pos, std::string& out, size_t base = 0, bool validate = true) {
+    return decode_escapes(str, len, pos, out, validate, base);
+}
+
+} // namespace jsonn::detail
@@ -0,0 +1,190 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "jsonn.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace jsonn {
+
+struct ThreadPool::Impl {
+    struct Queue {
+        std::mutex m;
+        std::deque<size_t> items;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<Queue> queues; // one per worker, the last one is the caller's
+    std::mutex run_mutex;      // one run() at a time
+
+    std::mutex m;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* task = nullptr;
+    std::atomic<size_t> remaining{0};
+    size_t active = 0;
+    uint64_t generation = 0;
+    std::exception_ptr error;
+    bool stop = false;
+
+    explicit Impl(size_t workers) : queues(workers + 1) {
+        for (size_t i = 0; i < workers; ++i) threads.emplace_back([this, i] { worker(i); });
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    bool pop(size_t self, size_t& item) {
+        Queue& q = queues[self];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (q.items.empty()) return false;
+        item = q.items.front();
+        q.items.pop_front();
+        return true;
+    }
+
+    // Takes from the back of another queue, the end its owner reaches last
+    bool steal(size_t self, size_t& item) {
+        for (size_t k = 1; k < queues.size(); ++k) {
+            Queue& q = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.items.empty()) continue;
+            item = q.items.back();
+            q.items.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t self) {
+        size_t item;
+        while (pop(self, item) || steal(self, item)) {
+            try {
+                (*task)(item);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m);
+                if (!error) error = std::current_exception();
+            }
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m);
+                done.notify_all();
+            }
+        }
+    }
+
+    void worker(size_t self) {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                ++active;
+            }
+            work(self);
+            {
+                std::lock_guard<std::mutex> lock(m);
+                --active;
+            }
+            done.notify_all();
+        }
+    }
+};
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    impl = std::make_unique<Impl>(threads - 1);
+}
+
+ThreadPool::~ThreadPool() = default;
+
+size_t ThreadPool::size() const {
+    return impl->threads.size() + 1;
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    if (impl->threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(impl->run_mutex);
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->task = &task;
+        impl->error = nullptr;
+        impl->remaining = count;
+    }
+
+    // Contiguous ranges per queue, so neighbouring tasks stay on one thread
+    // until somebody has to steal
+    size_t n = impl->queues.size();
+    for (size_t q = 0; q < n; ++q) {
+        std::lock_guard<std::mutex> lock(impl->queues[q].m);
+        for (size_t i = q * count / n; i < (q + 1) * count / n; ++i) impl->queues[q].items.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        ++impl->generation;
+    }
+    impl->wake.notify_all();
+
+    impl->work(n - 1);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(impl->m);
+        impl->done.wait(lock, [&] { return impl->remaining == 0 && impl->active == 0; });
+        impl->task = nullptr;
+        error = impl->error;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace jsonn
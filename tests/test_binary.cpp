@@ -0,0 +1,256 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Binary encoding: round trips and rejection of damaged buffers
+
+#include "check.h"
+#include "jsonn.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace {
+
+jsonn::Value round_trip(const jsonn::Value& v) {
+    return jsonn::decode_binary(jsonn::encode_binary(v));
+}
+
+void test_integers() {
+    jsonn::Array a;
+    a.push_back(INT64_MIN);
+    a.push_back(INT64_MAX);
+    a.push_back(int64_t(-1));
+    a.push_back(int64_t(0));
+    a.push_back(UINT64_MAX);
+    a.push_back(uint64_t(INT64_MAX) + 1);
+    jsonn::Value v(std::move(a));
+    jsonn::Value back = round_trip(v);
+    CHECK(back == v);
+    CHECK_EQ(jsonn::serialize(back), jsonn::serialize(v));
+
+    std::string bytes = jsonn::encode_binary(v);
+    jsonn::BinaryValue root = jsonn::BinaryDocument(bytes).root();
+    CHECK_EQ(root[0].as_int(), INT64_MIN);
+    CHECK_EQ(root[1].as_int(), INT64_MAX);
+    CHECK_EQ(root[4].as_uint(), UINT64_MAX);
+    CHECK_EQ(root[5].as_uint(), uint64_t(INT64_MAX) + 1);
+    CHECK_EQ(error_of([&] { root[4].as_int(); }), std::string("Integer out of range"));
+    CHECK_EQ(error_of([&] { root[2].as_uint(); }), std::string("Integer out of range"));
+}
+
+void test_doubles() {
+    const double values[] = {0.0, -0.0, 0.1, -1.5e300, 5e-324, std::numeric_limits<double>::max(), 1e100};
+    for (double d : values) {
+        jsonn::Value back = round_trip(jsonn::Value(d));
+        CHECK(back.is_number() && !back.is_int());
+        CHECK_EQ(std::bit_cast<uint64_t>(back.as_number()), std::bit_cast<uint64_t>(d));
+    }
+    // Bits are stored as they are, NaN included
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    std::string bytes = jsonn::encode_binary(jsonn::Value(nan));
+    CHECK(std::isnan(jsonn::BinaryDocument(bytes).root().as_number()));
+}
+
+void test_empty_containers() {
+    jsonn::Value v = jsonn::parse(R"({"a":[],"o":{},"s":"","n":[[],{}]})");
+    CHECK(round_trip(v) == v);
+    CHECK(round_trip(jsonn::parse("[]")) == jsonn::parse("[]"));
+    CHECK(round_trip(jsonn::parse("{}")) == jsonn::parse("{}"));
+
+    std::string bytes = jsonn::encode_binary(v);
+    jsonn::BinaryValue root = jsonn::BinaryDocument(bytes).root();
+    CHECK_EQ(root["a"].size(), size_t(0));
+    CHECK_EQ(root["o"].size(), size_t(0));
+    CHECK(!root["o"].find("x"));
+    CHECK_EQ(root["s"].as_string(), std::string_view());
+}
+
+void test_large_object() {
+    // Past Object::hash_threshold keys, so the decoded object is hash indexed
+    jsonn::Object o;
+    for (int i = 40; i > 0; --i) o.insert_or_assign("key" + std::to_string(i), i);
+    jsonn::Value v(std::move(o));
+    jsonn::Value back = round_trip(v);
+    CHECK(back == v);
+    CHECK_EQ(jsonn::serialize(back), jsonn::serialize(v));
+    for (int i = 1; i <= 40; ++i) {
+        CHECK_EQ(back.as_object().at("key" + std::to_string(i)).as_int(), int64_t(i));
+    }
+
+    std::string bytes = jsonn::encode_binary(v);
+    jsonn::BinaryObject bo = jsonn::BinaryDocument(bytes).root().as_object();
+    CHECK_EQ(bo.size(), size_t(40));
+    CHECK_EQ(bo.key(0), std::string_view("key40"));
+    for (int i = 1; i <= 40; ++i) {
+        auto m = bo.find("key" + std::to_string(i));
+        CHECK(m && m->as_int() == i);
+    }
+    CHECK(!bo.find("key0"));
+    CHECK(!bo.find("key41"));
+}
+
+void test_embedded_nul() {
+    std::string s("a\0b\0", 4);
+    jsonn::Object o;
+    o.insert_or_assign(std::string("k\0", 2), s);
+    jsonn::Value v(std::move(o));
+    jsonn::Value back = round_trip(v);
+    CHECK(back == v);
+
+    std::string bytes = jsonn::encode_binary(v);
+    jsonn::BinaryValue root = jsonn::BinaryDocument(bytes).root();
+    auto m = root.find(std::string_view("k\0", 2));
+    CHECK(m && m->as_string() == s);
+    CHECK(!root.find("k"));
+}
+
+// Throws for a damaged buffer, either when opened or when decoded
+bool rejected(std::string_view bytes) {
+    return !error_of([&] { jsonn::BinaryDocument(bytes).root().to_value(); }).empty();
+}
+
+void test_truncated() {
+    std::string bytes = jsonn::encode_binary(jsonn::parse(R"({"k":[1,"s",{"x":2.5}],"t":true})"));
+    for (size_t n = 0; n < bytes.size(); ++n) CHECK(rejected(std::string_view(bytes).substr(0, n)));
+    CHECK(!rejected(bytes));
+}
+
+void put32(std::string& bytes, size_t at, uint32_t v) {
+    for (int i = 0; i < 4; ++i) bytes[at + i] = static_cast<char>(v >> (8 * i));
+}
+
+void test_corrupt() {
+    // Layout of ["s"]: 12 byte header, the string node at 12 (tag, u32
+    // length, byte), then the array at 18 (tag, u32 count, u32 child)
+    const std::string good = jsonn::encode_binary(jsonn::parse(R"(["s"])"));
+    CHECK_EQ(good.size(), size_t(27));
+
+    std::string b = good;
+    b[0] = 'X';
+    CHECK_EQ(error_of([&] { jsonn::BinaryDocument{b}; }), std::string("Not a binary document"));
+    b = good;
+    put32(b, 4, 2);
+    CHECK_EQ(error_of([&] { jsonn::BinaryDocument{b}; }), std::string("Unsupported binary document version"));
+
+    std::string corrupt("Corrupt binary document");
+    b = good;
+    put32(b, 8, 27); // root past the end
+    CHECK_EQ(error_of([&] { jsonn::BinaryDocument{b}; }), corrupt);
+    b = good;
+    put32(b, 13, 100); // string longer than the buffer
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(b); }), corrupt);
+    b = good;
+    put32(b, 19, 1000); // more elements than fit
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(b); }), corrupt);
+    b = good;
+    put32(b, 23, 18); // child pointing at its parent, a cycle
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(b); }), corrupt);
+    b = good;
+    b[12] = 42; // unknown tag
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(b); }), corrupt);
+
+    // Any single damaged byte is either harmless or rejected, never read
+    // out of bounds
+    for (size_t i = 0; i < good.size(); ++i) {
+        b = good;
+        b[i] = static_cast<char>(0xff);
+        error_of([&] { jsonn::decode_binary(b); });
+    }
+}
+
+// A valid buffer of depth nested arrays, each the only element of the next
+std::string nested_arrays(size_t depth) {
+    std::string b = jsonn::encode_binary(jsonn::Value());
+    uint32_t child = 12;
+    for (size_t i = 0; i < depth; ++i) {
+        uint32_t at = static_cast<uint32_t>(b.size());
+        b.push_back(7); // array tag
+        b.append(8, '\0');
+        put32(b, at + 1, 1);
+        put32(b, at + 5, child);
+        child = at;
+    }
+    put32(b, 8, child);
+    return b;
+}
+
+void test_depth_limit() {
+    // Offsets pointing backwards rule out cycles but not depth, so a crafted
+    // buffer could otherwise overflow the stack
+    std::string deep = nested_arrays(200000);
+    CHECK(jsonn::BinaryDocument(deep).root().is_array());
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(deep); }).rfind("Nesting too deep at offset ", 0), size_t(0));
+    CHECK_EQ(error_of([&] { jsonn::BinaryDocument(deep).root().to_value(); }).rfind("Nesting too deep", 0), size_t(0));
+
+    // The limit matches parse()
+    std::string json = std::string(1024, '[') + std::string(1024, ']');
+    jsonn::Value v = jsonn::parse(json);
+    CHECK(jsonn::decode_binary(jsonn::encode_binary(v)) == v);
+    CHECK(jsonn::decode_binary(nested_arrays(1024)) == jsonn::parse(std::string(1024, '[') + "null" + std::string(1024, ']')));
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(nested_arrays(1025)); }), std::string("Nesting too deep at offset 13"));
+    CHECK_EQ(error_of([&] { jsonn::decode_binary(nested_arrays(3), 2); }), std::string("Nesting too deep at offset 13"));
+    CHECK(!jsonn::BinaryDocument(nested_arrays(3)).root().to_value(3).is_null());
+}
+
+void test_open() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "jsonn_test_binary.bin";
+    jsonn::Value v = jsonn::parse(R"({"a":[1,2,3],"b":"text"})");
+    jsonn::save_binary(path.string(), v);
+    CHECK(jsonn::BinaryDocument::open(path.string()).root().to_value() == v);
+
+    // A file cut short, as by an interrupted write, fails to open or decode
+    std::string bytes = jsonn::encode_binary(v);
+    for (size_t n : {size_t(0), size_t(8), bytes.size() / 2, bytes.size() - 1}) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(n));
+        CHECK(!error_of([&] { jsonn::BinaryDocument::open(path.string()).root().to_value(); }).empty());
+    }
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main() {
+    test_integers();
+    test_doubles();
+    test_empty_containers();
+    test_large_object();
+    test_embedded_nul();
+    test_truncated();
+    test_corrupt();
+    test_depth_limit();
+    test_open();
+    return check_result();
+}
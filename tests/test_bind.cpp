@@ -0,0 +1,101 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Struct bindings: parse_as, serialize_as and parse_jsonl_as
+
+#include "check.h"
+#include "jsonn_bind.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Record {
+    int64_t id = 0;
+    std::vector<bool> flags;
+};
+JSONN_DEFINE(Record, id, flags)
+
+// Forces the parallel paths even for small inputs
+jsonn::ParallelOptions parallel() {
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 16;
+    return options;
+}
+
+void test_vector_bool() {
+    Record r = jsonn::parse_as<Record>(R"({"id":7,"flags":[true,false,true]})");
+    CHECK_EQ(r.id, int64_t(7));
+    CHECK(r.flags == std::vector<bool>({true, false, true}));
+    CHECK_EQ(jsonn::serialize_as(r), std::string(R"({"id":7,"flags":[true,false,true]})"));
+}
+
+const char* bad_jsonl = "{\"id\":1,\"flags\":[]}\n"
+                        "\n"
+                        "{\"id\":2,\"flags\":[1]}\n"
+                        "{\"id\":3,\"flags\":[false]}\n"
+                        "{\"id\":\n";
+
+void test_jsonl_errors(const jsonn::ParallelOptions& base) {
+    // Lines are numbered from 1 like parse_jsonl(), empty lines included.
+    // Line 3 is valid JSON but not a Record.
+    CHECK_EQ(error_of([&] { jsonn::parse_jsonl_as<Record>(bad_jsonl, base); }).substr(0, 8), std::string("Line 3: "));
+
+    jsonn::ParallelOptions options = base;
+    options.skip_errors = true;
+    std::vector<jsonn::JsonlError> errors;
+    options.on_error = [&](const jsonn::JsonlError& e) { errors.push_back(e); };
+    std::vector<Record> records = jsonn::parse_jsonl_as<Record>(bad_jsonl, options);
+    CHECK_EQ(records.size(), size_t(2));
+    if (records.size() == 2) {
+        CHECK_EQ(records[0].id, int64_t(1));
+        CHECK_EQ(records[1].id, int64_t(3));
+        CHECK(records[1].flags == std::vector<bool>({false}));
+    }
+    CHECK_EQ(errors.size(), size_t(2));
+    if (errors.size() == 2) {
+        CHECK_EQ(errors[0].line, size_t(3));
+        CHECK_EQ(errors[0].offset, size_t(21));
+        CHECK_EQ(errors[0].text, std::string_view("{\"id\":2,\"flags\":[1]}"));
+        CHECK_EQ(errors[1].line, size_t(5));
+        CHECK_EQ(errors[1].text, std::string_view("{\"id\":"));
+    }
+}
+
+} // namespace
+
+int main() {
+    test_vector_bool();
+    test_jsonl_errors({});
+    test_jsonl_errors(parallel());
+    return check_result();
+}
@@ -0,0 +1,158 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Document, Element and the array/object views
+
+#include "check.h"
+#include "jsonn.h"
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void test_array_bounds() {
+    jsonn::Document doc;
+    jsonn::Element root = doc.parse("[10,20,30]");
+    jsonn::ArrayView arr = root.as_array();
+    CHECK_EQ(arr[2].as_int(), int64_t(30));
+    CHECK_EQ(error_of([&] { arr[3]; }), std::string("Array index out of range"));
+    CHECK_EQ(error_of([&] { root[3]; }), std::string("Array index out of range"));
+
+    bool out_of_range = false;
+    try {
+        doc.parse("[]").as_array()[0];
+    } catch (const std::out_of_range&) {
+        out_of_range = true;
+    }
+    CHECK(out_of_range);
+}
+
+jsonn::ParseOptions with_mode(jsonn::ParseMode mode) {
+    jsonn::ParseOptions options;
+    options.mode = mode;
+    return options;
+}
+
+bool points_into(std::string_view s, std::string_view buffer) {
+    return s.data() >= buffer.data() && s.data() + s.size() <= buffer.data() + buffer.size();
+}
+
+void test_borrow_strings() {
+    const std::string json = R"({"plain":"abc","escaped":"a\nb","k\u0065y":["",  "text"]})";
+    for (jsonn::ParseMode mode : {jsonn::ParseMode::scalar, jsonn::ParseMode::indexed}) {
+        jsonn::ParseOptions options = with_mode(mode);
+        options.borrow_strings = true;
+        jsonn::Document doc;
+        jsonn::Element root = doc.parse(json, options);
+
+        // Strings without escapes are views of the input, keys included
+        CHECK_EQ(root["plain"].as_string(), std::string_view("abc"));
+        CHECK(points_into(root["plain"].as_string(), json));
+        CHECK(points_into(root["key"][1].as_string(), json));
+        CHECK(points_into((*root.as_object().begin()).first, json));
+        // Decoded strings are copied into the arena
+        CHECK_EQ(root["escaped"].as_string(), std::string_view("a\nb"));
+        CHECK(!points_into(root["escaped"].as_string(), json));
+        auto [key, value] = *++++root.as_object().begin();
+        CHECK_EQ(key, std::string_view("key"));
+        CHECK(!points_into(key, json));
+
+        // Without the option nothing points into the input
+        jsonn::Element copied = doc.parse(json, with_mode(mode));
+        CHECK_EQ(copied["plain"].as_string(), std::string_view("abc"));
+        CHECK(!points_into(copied["plain"].as_string(), json));
+        CHECK(!points_into((*copied.as_object().begin()).first, json));
+    }
+}
+
+void test_reuse() {
+    std::string big = "[";
+    for (int i = 0; i < 2000; ++i) big += (i ? "," : "") + std::string(R"({"id":)") + std::to_string(i) + R"(,"name":"record with a long name"})";
+    big += "]";
+
+    // Small blocks, so the first parse needs several of them
+    jsonn::Document doc(1024);
+    jsonn::Element root = doc.parse(big);
+    CHECK_EQ(root.size(), size_t(2000));
+    CHECK_EQ(root[1999]["id"].as_int(), int64_t(1999));
+    size_t capacity = doc.get_arena().capacity();
+    CHECK(capacity > 1024);
+
+    // Parsing again reuses the merged block instead of allocating
+    for (int round = 0; round < 3; ++round) {
+        root = doc.parse(big);
+        CHECK_EQ(doc.get_arena().capacity(), capacity);
+        CHECK(root.to_value() == jsonn::parse(big));
+        root = doc.parse(R"({"small":[1,2,3]})");
+        CHECK_EQ(doc.get_arena().capacity(), capacity);
+        CHECK_EQ(root["small"][2].as_int(), int64_t(3));
+    }
+    CHECK(doc.root()["small"].size() == 3);
+
+    // A failed parse leaves the Document usable
+    CHECK(!error_of([&] { doc.parse("[1,"); }).empty());
+    CHECK_EQ(doc.parse("[true]")[0].as_bool(), true);
+}
+
+void test_to_value() {
+    const char* docs[] = {
+        "null", "true", "-5", "18446744073709551615", "2.5e-3", R"("a\u00e9\ud83d\ude00")", "[]", "{}",
+        R"({"a":[1,{"b":null,"c":[[],{}]}],"d":"x","e":-9223372036854775808,"f":1e300})",
+    };
+    for (jsonn::ParseMode mode : {jsonn::ParseMode::scalar, jsonn::ParseMode::indexed}) {
+        for (const char* json : docs) {
+            jsonn::Document doc;
+            CHECK(doc.parse(json, with_mode(mode)).to_value() == jsonn::parse(json));
+        }
+    }
+}
+
+void test_duplicate_keys() {
+    // The last duplicate wins, like Value
+    jsonn::Document doc;
+    jsonn::Element root = doc.parse(R"({"a":1,"b":0,"a":2})");
+    CHECK_EQ(root["a"].as_int(), int64_t(2));
+    CHECK_EQ(root.find("a")->as_int(), int64_t(2));
+    CHECK(!root.find("c"));
+    CHECK(root.to_value() == jsonn::parse(R"({"a":2,"b":0})"));
+    CHECK_EQ(jsonn::parse(R"({"a":1,"b":0,"a":2})")["a"].as_int(), int64_t(2));
+}
+
+} // namespace
+
+int main() {
+    test_array_bounds();
+    test_borrow_strings();
+    test_reuse();
+    test_to_value();
+    test_duplicate_keys();
+    return check_result();
+}
@@ -0,0 +1,274 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// JSONL parsing and serialization, serial and parallel paths
+
+#include "check.h"
+#include "jsonn.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// Forces the parallel paths even for small inputs
+jsonn::ParallelOptions parallel() {
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 64;
+    options.serial_records = 0;
+    options.batch_records = 1;
+    return options;
+}
+
+void test_serialize_keeps_spaces() {
+    // Whitespace inside strings once got stripped from the output
+    std::vector<jsonn::Value> records(5, jsonn::parse(R"({"a":"has spaces"})"));
+    std::string expected;
+    for (size_t i = 0; i < records.size(); ++i) expected += "{\"a\":\"has spaces\"}\n";
+
+    CHECK_EQ(jsonn::serialize_jsonl(records), expected);
+    CHECK_EQ(jsonn::serialize_jsonl(records, parallel()), expected);
+    std::string streamed;
+    jsonn::serialize_jsonl_to([&](std::string_view s) { streamed.append(s); }, records, parallel());
+    CHECK_EQ(streamed, expected);
+}
+
+// Long enough to outgrow the small read buffers below
+const std::string long_value(300, 'x');
+// Lines: a record, a blank line, a long record with a \r\n ending, a blank
+// \r\n line, another record and a last one without a newline
+const std::string reader_input = "{\"a\":1}\n\n{\"b\":\"" + long_value + "\"}\r\n\r\n[1,2]\n3";
+
+void check_records(jsonn::JsonlReader& reader) {
+    jsonn::Value v;
+    CHECK(reader.next(v));
+    CHECK(v == jsonn::parse(R"({"a":1})"));
+    CHECK_EQ(reader.line_number(), size_t(1));
+    CHECK(reader.next(v));
+    CHECK_EQ(v["b"].as_string(), long_value);
+    CHECK_EQ(reader.line_number(), size_t(3));
+    std::vector<jsonn::Value> batch;
+    CHECK_EQ(reader.next_batch(batch, 10), size_t(2));
+    CHECK(batch.size() == 2 && batch[0] == jsonn::parse("[1,2]") && batch[1] == jsonn::Value(3));
+    CHECK_EQ(reader.line_number(), size_t(6));
+    CHECK(!reader.next(v));
+    CHECK_EQ(reader.next_batch(batch, 10), size_t(0));
+}
+
+// Writes text into a pipe a few bytes at a time, so reads come back short
+// and lines straddle them
+template <class F>
+void with_pipe(const std::string& text, F&& read) {
+    int fds[2];
+    CHECK_EQ(::pipe(fds), 0);
+    std::thread writer([&] {
+        for (size_t i = 0; i < text.size(); i += 3) {
+            ssize_t n = ::write(fds[1], text.data() + i, std::min<size_t>(3, text.size() - i));
+            (void)n;
+        }
+        ::close(fds[1]);
+    });
+    read(fds[0]);
+    writer.join();
+    ::close(fds[0]);
+}
+
+void test_reader() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "jsonn_test_reader.jsonl";
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << reader_input;
+
+    // Buffers smaller than a line, than the long line, and than the file
+    for (size_t buffer_size : {size_t(1), size_t(4), size_t(16), size_t(64), size_t(1) << 20}) {
+        jsonn::JsonlReader file(path.string(), buffer_size);
+        check_records(file);
+        with_pipe(reader_input, [&](int fd) {
+            jsonn::JsonlReader reader(fd, buffer_size);
+            check_records(reader);
+        });
+    }
+
+    // Lines come back without their endings, blank ones skipped
+    jsonn::JsonlReader lines(path.string(), 8);
+    std::vector<std::string> seen;
+    while (auto line = lines.next_line()) seen.emplace_back(*line);
+    CHECK(seen == std::vector<std::string>({"{\"a\":1}", "{\"b\":\"" + long_value + "\"}", "[1,2]", "3"}));
+
+    std::vector<jsonn::Value> all;
+    jsonn::for_each_jsonl(path.string(), [&](jsonn::Value&& v) { all.push_back(std::move(v)); }, 4);
+    CHECK_EQ(all.size(), size_t(4));
+
+    std::filesystem::remove(path);
+    CHECK_EQ(error_of([&] { jsonn::JsonlReader r(path.string()); }), "Cannot open file: " + path.string());
+}
+
+void test_reader_errors() {
+    // Errors carry the line number, blank lines counted
+    const std::string text = "1\n\r\n\n[2,\n4\n";
+    for (size_t buffer_size : {size_t(2), size_t(1) << 20}) {
+        with_pipe(text, [&](int fd) {
+            jsonn::JsonlReader reader(fd, buffer_size);
+            jsonn::Value v;
+            CHECK(reader.next(v));
+            CHECK_EQ(error_of([&] { reader.next(v); }), "Line 4: " + error_of([] { jsonn::parse("[2,"); }));
+            // The bad line is consumed, reading carries on after it
+            CHECK(reader.next(v) && v == jsonn::Value(4));
+            CHECK_EQ(reader.line_number(), size_t(5));
+        });
+        with_pipe(text, [&](int fd) {
+            jsonn::JsonlReader reader(fd, buffer_size);
+            std::vector<jsonn::Value> batch;
+            CHECK(error_of([&] { reader.next_batch(batch, 10); }).rfind("Line 4: ", 0) == 0);
+            CHECK_EQ(batch.size(), size_t(1));
+        });
+    }
+}
+
+// Input with bad and empty lines spread over many chunks: where each
+// non-empty line starts, its 1-based number and whether it parses
+struct Sample {
+    std::string text;
+    std::vector<size_t> offsets;
+    std::vector<size_t> numbers;
+    std::vector<bool> good;
+};
+
+Sample sample() {
+    Sample s;
+    for (size_t n = 1; n <= 300; ++n) {
+        if (n % 11 == 0) {
+            s.text += n % 2 ? "\n" : "\r\n";
+            continue;
+        }
+        s.offsets.push_back(s.text.size());
+        s.numbers.push_back(n);
+        bool good = n % 37 != 0 && n != 299;
+        s.good.push_back(good);
+        s.text += good ? "{\"n\":" + std::to_string(n) + "}" : "{\"n\":" + std::to_string(n) + ",}";
+        s.text += n % 5 ? "\n" : "\r\n";
+    }
+    return s;
+}
+
+void test_errors_across_chunks() {
+    Sample s = sample();
+    for (size_t chunk : {size_t(1), size_t(7), size_t(64), size_t(1000), size_t(0)}) {
+        jsonn::ParallelOptions options;
+        options.serial_threshold = chunk ? 0 : SIZE_MAX;
+        options.chunk_size = chunk;
+
+        // The first bad line in the input is the one thrown
+        CHECK_EQ(error_of([&] { jsonn::parse_jsonl(s.text, options); }).substr(0, 9), std::string("Line 37: "));
+
+        options.skip_errors = true;
+        std::vector<jsonn::JsonlError> errors;
+        options.on_error = [&](const jsonn::JsonlError& e) { errors.push_back(e); };
+        std::vector<jsonn::Value> values = jsonn::parse_jsonl(s.text, options);
+
+        std::vector<int64_t> expected_values;
+        std::vector<size_t> expected_errors;
+        for (size_t i = 0; i < s.numbers.size(); ++i) {
+            if (s.good[i]) expected_values.push_back(static_cast<int64_t>(s.numbers[i]));
+            else expected_errors.push_back(i);
+        }
+        CHECK_EQ(values.size(), expected_values.size());
+        for (size_t i = 0; i < values.size() && i < expected_values.size(); ++i) {
+            CHECK_EQ(values[i]["n"].as_int(), expected_values[i]);
+        }
+        // Reported in input order, numbered and placed in the whole input
+        CHECK_EQ(errors.size(), expected_errors.size());
+        for (size_t k = 0; k < errors.size() && k < expected_errors.size(); ++k) {
+            size_t i = expected_errors[k];
+            CHECK_EQ(errors[k].line, s.numbers[i]);
+            CHECK_EQ(errors[k].offset, s.offsets[i]);
+            CHECK_EQ(errors[k].text.data(), s.text.data() + s.offsets[i]);
+            CHECK_EQ(errors[k].text, "{\"n\":" + std::to_string(s.numbers[i]) + ",}");
+            CHECK(!errors[k].message.empty());
+        }
+
+        // Without on_error bad lines are dropped silently
+        options.on_error = nullptr;
+        CHECK_EQ(jsonn::parse_jsonl(s.text, options).size(), expected_values.size());
+    }
+
+    // A bad last line without a newline, and nothing but bad lines
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 4;
+    CHECK_EQ(error_of([&] { jsonn::parse_jsonl("1\n2\n\n[", options); }).substr(0, 8), std::string("Line 4: "));
+    options.skip_errors = true;
+    size_t reported = 0;
+    options.on_error = [&](const jsonn::JsonlError&) { ++reported; };
+    CHECK(jsonn::parse_jsonl("x\ny\nz", options).empty());
+    CHECK_EQ(reported, size_t(3));
+    CHECK(jsonn::parse_jsonl("", options).empty());
+}
+
+void test_parse_jsonl_lines() {
+    Sample s = sample();
+    for (size_t chunk : {size_t(1), size_t(50), size_t(0)}) {
+        jsonn::ParallelOptions options;
+        options.serial_threshold = chunk ? 0 : SIZE_MAX;
+        options.chunk_size = chunk;
+        std::vector<jsonn::JsonlLine> lines = jsonn::parse_jsonl_lines(s.text, options);
+
+        // Every non-empty line, good or bad, in order
+        CHECK_EQ(lines.size(), s.numbers.size());
+        for (size_t i = 0; i < lines.size() && i < s.numbers.size(); ++i) {
+            CHECK_EQ(lines[i].line, s.numbers[i]);
+            CHECK_EQ(lines[i].offset, s.offsets[i]);
+            CHECK_EQ(lines[i].ok(), bool(s.good[i]));
+            if (s.good[i]) {
+                CHECK_EQ(lines[i].value["n"].as_int(), static_cast<int64_t>(s.numbers[i]));
+            } else {
+                CHECK(lines[i].value.is_null());
+                CHECK(!lines[i].error.empty());
+            }
+        }
+    }
+    CHECK(jsonn::parse_jsonl_lines("\n\r\n\n").empty());
+}
+
+} // namespace
+
+int main() {
+    test_serialize_keeps_spaces();
+    test_reader();
+    test_reader_errors();
+    test_errors_across_chunks();
+    test_parse_jsonl_lines();
+    return check_result();
+}
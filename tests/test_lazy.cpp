@@ -0,0 +1,63 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// LazyDocument and LazyValue
+
+#include "check.h"
+#include "jsonn.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+void test_exact_integers() {
+    jsonn::LazyDocument doc;
+    jsonn::LazyValue root = doc.parse(R"({"id":9007199254740993,"big":18446744073709551615,"neg":-9223372036854775808,"d":1.5,"s":"x"})");
+
+    CHECK(root["id"].is_int());
+    CHECK_EQ(root["id"].as_int(), int64_t(9007199254740993));
+    CHECK_EQ(root["id"].as_uint(), uint64_t(9007199254740993));
+    CHECK_EQ(root["big"].as_uint(), UINT64_MAX);
+    CHECK_EQ(root["neg"].as_int(), INT64_MIN);
+
+    CHECK(!root["d"].is_int());
+    CHECK(!root["s"].is_int());
+    CHECK_EQ(error_of([&] { root["d"].as_int(); }), std::string("LazyValue is not an integer"));
+    CHECK_EQ(error_of([&] { root["big"].as_int(); }), std::string("Integer out of range"));
+    CHECK_EQ(error_of([&] { root["neg"].as_uint(); }), std::string("Integer out of range"));
+}
+
+} // namespace
+
+int main() {
+    test_exact_integers();
+    return check_result();
+}
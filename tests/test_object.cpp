@@ -0,0 +1,274 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Object storage: insertion order, the hash index and shared key lists
+
+#include "check.h"
+#include "jsonn.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> keys_of(const jsonn::Object& o) {
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : o) keys.push_back(key);
+    return keys;
+}
+
+std::string key(int i) {
+    return "key" + std::to_string(i);
+}
+
+void test_hash_index() {
+    jsonn::Object o;
+    const int n = 100;
+    for (int i = 0; i < n; ++i) {
+        o.insert_or_assign(key(i), i);
+        // Every key stays reachable while the index grows past the threshold
+        for (int j = 0; j <= i; ++j) CHECK(o.contains(key(j)));
+        CHECK(!o.contains(key(i + 1)));
+    }
+    CHECK_EQ(o.size(), size_t(n));
+
+    // Erase every third key, from both sides of the threshold
+    for (int i = 0; i < n; i += 3) CHECK_EQ(o.erase(key(i)), size_t(1));
+    CHECK_EQ(o.erase(key(0)), size_t(0));
+    for (int i = 0; i < n; ++i) {
+        auto it = o.find(key(i));
+        if (i % 3 == 0) {
+            CHECK(it == o.end());
+        } else {
+            CHECK(it != o.end() && it->second.as_int() == i);
+        }
+    }
+
+    // Down below the threshold the lookups go linear again
+    for (int i = 0; i < n; ++i) o.erase(key(i));
+    CHECK(o.empty());
+    o["x"] = 1;
+    CHECK_EQ(o.at("x").as_int(), int64_t(1));
+    CHECK(!o.contains(key(1)));
+    CHECK_EQ(error_of([&] { o.at("missing"); }), std::string("Key not found: missing"));
+}
+
+void test_insertion_order() {
+    jsonn::Object o;
+    for (int i = 20; i > 0; --i) o[key(i)] = i;
+    o["key5"] = "replaced";
+    CHECK(o.emplace("key7", 0).second == false);
+    CHECK(o.insert(std::pair<std::string, jsonn::Value>("key3", 0)).second == false);
+    CHECK_EQ(o.at("key7").as_int(), int64_t(7));
+
+    std::vector<std::string> expected;
+    for (int i = 20; i > 0; --i) expected.push_back(key(i));
+    CHECK(keys_of(o) == expected);
+
+    // Removing keeps the order of the rest
+    o.erase("key10");
+    auto moved = o.extract("key20");
+    CHECK(moved && moved->as_int() == 20);
+    expected.erase(expected.begin() + 10);
+    expected.erase(expected.begin());
+    CHECK(keys_of(o) == expected);
+    CHECK_EQ(o.at("key5").as_string(), std::string("replaced"));
+    CHECK_EQ(jsonn::serialize(jsonn::parse(R"({"b":1,"a":2,"c":3})")), std::string(R"({"b":1,"a":2,"c":3})"));
+}
+
+void test_copy_on_write() {
+    // Plain copies share the key list until one of them changes it
+    jsonn::Object a;
+    for (int i = 0; i < 20; ++i) a[key(i)] = i;
+    jsonn::Object b = a;
+    b["extra"] = true;
+    b.erase("key3");
+    b["key4"] = "changed";
+    CHECK_EQ(a.size(), size_t(20));
+    CHECK(!a.contains("extra"));
+    CHECK(a.contains("key3"));
+    CHECK_EQ(a.at("key4").as_int(), int64_t(4));
+    CHECK_EQ(b.size(), size_t(20));
+
+    // Parsed objects share their table's key list
+    jsonn::KeyTable table;
+    jsonn::ParseOptions options;
+    options.keys = &table;
+    std::string record = "{";
+    for (int i = 0; i < 20; ++i) record += (i ? ",\"" : "\"") + key(i) + "\":" + std::to_string(i);
+    record += "}";
+    jsonn::Value original = jsonn::parse(record, options);
+    jsonn::Value copy = jsonn::parse(record, options);
+    jsonn::Value snapshot = jsonn::parse(record);
+    CHECK(original == snapshot);
+
+    jsonn::Object& c = *copy.try_get_object();
+    c.erase("key0");
+    c.extract("key19");
+    c["new"] = 1;
+    c.insert_or_assign("key5", "five");
+    CHECK(original == snapshot);
+    CHECK(keys_of(original.as_object()) == keys_of(snapshot.as_object()));
+    CHECK_EQ(c.size(), size_t(19));
+    CHECK(!c.contains("key0"));
+    CHECK_EQ(c.at("key5").as_string(), std::string("five"));
+    // The table still hands out the original keys
+    CHECK(jsonn::parse(record, options) == snapshot);
+}
+
+void test_equality() {
+    // Key order doesn't matter, values and key sets do
+    CHECK(jsonn::parse(R"({"a":1,"b":[2],"c":{"d":3,"e":4}})") == jsonn::parse(R"({"c":{"e":4,"d":3},"b":[2],"a":1})"));
+    CHECK(jsonn::parse(R"({"a":1,"b":2})") != jsonn::parse(R"({"a":1,"b":3})"));
+    CHECK(jsonn::parse(R"({"a":1,"b":2})") != jsonn::parse(R"({"a":1,"c":2})"));
+    CHECK(jsonn::parse(R"({"a":1})") != jsonn::parse(R"({"a":1,"b":2})"));
+    CHECK(jsonn::parse(R"({})") == jsonn::Value(jsonn::Object()));
+
+    jsonn::Object forward, backward;
+    for (int i = 0; i < 40; ++i) forward[key(i)] = i;
+    for (int i = 39; i >= 0; --i) backward[key(i)] = i;
+    CHECK(forward == backward);
+    backward["key7"] = 8;
+    CHECK(forward != backward);
+}
+
+// Parses json with the table and without, and checks the results agree
+// on values and on key order
+jsonn::Value parse_with(jsonn::KeyTable& table, const std::string& json) {
+    jsonn::ParseOptions options;
+    options.keys = &table;
+    jsonn::Value tabled = jsonn::parse(json, options);
+    jsonn::Value plain = jsonn::parse(json);
+    CHECK(tabled == plain);
+    CHECK_EQ(jsonn::serialize(tabled), jsonn::serialize(plain));
+    return tabled;
+}
+
+void test_duplicate_keys() {
+    // A repeated key loops back to the same shape and overwrites the value
+    jsonn::KeyTable table;
+    jsonn::Value v = parse_with(table, R"({"a":1,"b":2,"a":3})");
+    CHECK_EQ(jsonn::serialize(v), std::string(R"({"a":3,"b":2})"));
+    CHECK_EQ(table.size(), size_t(2));
+    parse_with(table, R"({"a":1,"b":2,"a":3,"b":4})");
+    parse_with(table, R"({"a":1,"a":2,"a":3})");
+    parse_with(table, R"({"a":1,"b":2})");
+    CHECK_EQ(table.size(), size_t(2));
+    // The self-edge is followed on the next parse too
+    v = parse_with(table, R"({"a":1,"b":2,"a":5})");
+    CHECK_EQ(v["a"].as_int(), int64_t(5));
+    CHECK_EQ(v.as_object().size(), size_t(2));
+}
+
+void test_table_limits() {
+    // Past 32 branches from one shape the keys are stored per object
+    jsonn::KeyTable wide;
+    for (int i = 0; i < 40; ++i) parse_with(wide, "{\"" + key(i) + "\":" + std::to_string(i) + ",\"x\":true}");
+    CHECK_EQ(wide.size(), size_t(64));
+    for (int i = 0; i < 40; ++i) parse_with(wide, "{\"" + key(i) + "\":0,\"x\":false,\"" + key(i) + "\":1}");
+
+    // The table stops growing at max_shapes
+    jsonn::KeyTable few(5);
+    for (int i = 0; i < 10; ++i) {
+        parse_with(few, "{\"a" + std::to_string(i) + "\":1,\"b\":2,\"c\":{\"d\":3}}");
+        CHECK(few.size() <= 5);
+    }
+
+    // Objects longer than max_keys keep the interned prefix and add the rest
+    jsonn::KeyTable narrow(4096, 4);
+    std::string record = "{";
+    for (int i = 0; i < 10; ++i) record += (i ? ",\"" : "\"") + key(i) + "\":" + std::to_string(i);
+    parse_with(narrow, record + "}");
+    parse_with(narrow, record + ",\"key1\":\"again\",\"key9\":\"again\"}");
+    CHECK_EQ(narrow.size(), size_t(4));
+    jsonn::KeyTable two(4096, 2);
+    jsonn::Value v = parse_with(two, R"({"a":1,"b":2,"a":3,"c":4})");
+    CHECK_EQ(jsonn::serialize(v), std::string(R"({"a":3,"b":2,"c":4})"));
+    parse_with(two, R"({"a":1,"b":2,"c":3,"c":4,"a":5})");
+
+    // Values stay valid when their table is cleared or destroyed
+    jsonn::Value kept;
+    {
+        jsonn::KeyTable table;
+        kept = parse_with(table, record + "}");
+        table.clear();
+        CHECK_EQ(table.size(), size_t(0));
+        CHECK(kept == jsonn::parse(record + "}"));
+        parse_with(table, record + "}");
+    }
+    CHECK(kept == jsonn::parse(record + "}"));
+}
+
+void test_mutating_parsed_objects() {
+    // Changing one parsed object leaves the others with its key list alone
+    jsonn::KeyTable table;
+    for (int n : {3, 20}) {
+        std::string record = "{";
+        for (int i = 0; i < n; ++i) record += (i ? ",\"" : "\"") + key(i) + "\":" + std::to_string(i);
+        record += "}";
+        std::vector<jsonn::Value> parsed;
+        for (int i = 0; i < 4; ++i) parsed.push_back(parse_with(table, record));
+        size_t shapes = table.size();
+
+        jsonn::Object& a = *parsed[0].try_get_object();
+        a.erase("key1");
+        a["added"] = 1;
+        jsonn::Object& b = *parsed[1].try_get_object();
+        b.extract("key0");
+        b.insert_or_assign("key2", "changed");
+        jsonn::Object& c = *parsed[2].try_get_object();
+        c.clear();
+        c["only"] = true;
+
+        const jsonn::Value plain = jsonn::parse(record);
+        CHECK(parsed[3] == plain);
+        CHECK(keys_of(parsed[3].as_object()) == keys_of(plain.as_object()));
+        CHECK(!a.contains("key1") && a.contains("added") && a.size() == size_t(n));
+        CHECK(!b.contains("key0") && b.at("key2").as_string() == "changed");
+        CHECK_EQ(c.size(), size_t(1));
+
+        // Later parses get the untouched list, and the table didn't grow
+        for (int i = 0; i < 3; ++i) CHECK(parse_with(table, record) == plain);
+        CHECK_EQ(table.size(), shapes);
+    }
+}
+
+} // namespace
+
+int main() {
+    test_hash_index();
+    test_insertion_order();
+    test_copy_on_write();
+    test_equality();
+    test_duplicate_keys();
+    test_table_limits();
+    test_mutating_parsed_objects();
+    return check_result();
+}
@@ -0,0 +1,155 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Parser behaviour shared by the scalar and indexed modes and Document
+
+#include "check.h"
+#include "jsonn.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+jsonn::ParseOptions indexed() {
+    jsonn::ParseOptions options;
+    options.mode = jsonn::ParseMode::indexed;
+    return options;
+}
+
+// The same error from every parser, or "" if all accept the input
+std::string same_error(const std::string& json) {
+    jsonn::Document doc;
+    std::string scalar = error_of([&] { jsonn::parse(json); });
+    CHECK_EQ(error_of([&] { jsonn::parse(json, indexed()); }), scalar);
+    CHECK_EQ(error_of([&] { doc.parse(json, indexed()); }), scalar);
+    return scalar;
+}
+
+void test_unterminated_string() {
+    // Reported at the opening quote in every mode
+    CHECK_EQ(same_error("[1, \"abc"), std::string("Unterminated string at position 4"));
+    CHECK_EQ(same_error("[\"a\\\\\", \"abc\\"), std::string("Unterminated string at position 8"));
+    CHECK_EQ(same_error("{\"k\":[" + std::string(300, ' ') + "\"x\\\"y"), std::string("Unterminated string at position 306"));
+}
+
+void test_malformed() {
+    // Bytes glued on to a scalar are reported where they start
+    CHECK_EQ(same_error("[truex]"), std::string("Unexpected character: x at position 5"));
+    CHECK_EQ(same_error("{\"a\":falsey}"), std::string("Unexpected character: y at position 10"));
+    CHECK_EQ(same_error("nullx"), std::string("Unexpected character: x at position 4"));
+    CHECK_EQ(same_error("[1.5e3x]"), std::string("Unexpected character: x at position 6"));
+
+    const char* cases[] = {
+        "", " ", "[", "]", "{", "}", "[1,", "[1,]", "[,1]", "[1 2]", "[1\"a\"]", "[true false]", "[1true]",
+        "[tru]", "[nul", "nul", "fals", "True", "[-]", "[1.]", "[01]", "[1e]", "[1e+]", "[.5]", "[+1]", "[--1]",
+        "[0x10]", "[Infinity]", "[NaN]", "{\"a\"}", "{\"a\":}", "{\"a\" 1}", "{\"a\":1,}", "{\"a\":1\"b\":2}",
+        "{1:2}", "{\"a\":1]", "[1}", "[true}", "1 2", "{} {}", "[]]", "\"abc", "[\"a\\x\"]", "[nullnull]",
+        "[1,2,3,falsex,4]", "{\"k\":[{\"a\":truee}]}", "[1]x", "truex", "-", "-x", "1.0.0", "[1e5e5]",
+    };
+    for (const char* json : cases) CHECK(!same_error(json).empty());
+}
+
+double parse_double(const std::string& json) {
+    double scalar = jsonn::parse(json).as_number();
+    double index = jsonn::parse(json, indexed()).as_number();
+    CHECK(scalar == index && std::signbit(scalar) == std::signbit(index));
+    return scalar;
+}
+
+void test_double_range() {
+    // Underflow rounds to zero or the nearest subnormal
+    CHECK_EQ(parse_double("1e-400"), 0.0);
+    CHECK(std::signbit(parse_double("-1e-400")));
+    CHECK_EQ(parse_double("4.9406564584124654e-324"), std::nextafter(0.0, 1.0));
+    CHECK_EQ(parse_double("2.5e-320"), 2.5e-320);
+    CHECK_EQ(jsonn::parse("[1e-400]", indexed())[0].as_number(), 0.0);
+    CHECK_EQ(parse_double("1.7976931348623157e308"), 1.7976931348623157e308);
+
+    // Overflow is an error, JSON has no infinity to write back
+    CHECK_EQ(same_error("1e400"), std::string("Number out of range: 1e400 at position 0"));
+    CHECK_EQ(same_error("[-1.8e308]"), std::string("Number out of range: -1.8e308 at position 1"));
+}
+
+// parse_parallel gives the error parse() gives with the same options
+void check_parallel_error(const std::string& json, jsonn::ParseMode mode) {
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 64;
+    options.parse.mode = mode;
+    std::string serial = error_of([&] { jsonn::parse(json, options.parse); });
+    CHECK(!serial.empty());
+    CHECK_EQ(error_of([&] { jsonn::parse_parallel(json, options); }), serial);
+}
+
+void test_parallel_errors() {
+    std::string records;
+    for (int i = 0; i < 100; ++i) records += "{\"id\":" + std::to_string(i) + ",\"name\":\"record\"},";
+    std::string stray = records;
+    stray[100] = 'x';
+    for (jsonn::ParseMode mode : {jsonn::ParseMode::scalar, jsonn::ParseMode::indexed}) {
+        // A stray byte early on and an unterminated string at the end: the
+        // structural index only sees the latter
+        check_parallel_error("[" + stray + "\"abc", mode);
+        check_parallel_error("[" + records + "\"abc", mode);
+        check_parallel_error("[" + stray + "1]", mode);
+    }
+    CHECK_EQ(error_of([&] { jsonn::parse("[" + stray + "\"abc"); }).find("Unterminated"), std::string::npos);
+}
+
+void test_parse_file() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "jsonn_test_parse.json";
+    std::string json = R"({"a":[1,2,{"b":"text"}],"c":-2.5})";
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << json;
+    CHECK(jsonn::parse_file(path.string()) == jsonn::parse(json));
+    CHECK(jsonn::parse_file(path.string()) == jsonn::parse(json.data(), json.size()));
+
+    // An empty file maps nothing and fails like an empty string
+    std::ofstream(path, std::ios::binary | std::ios::trunc).flush();
+    std::string empty = error_of([] { jsonn::parse(""); });
+    CHECK(!empty.empty());
+    CHECK_EQ(error_of([&] { jsonn::parse_file(path.string()); }), empty);
+
+    std::filesystem::remove(path);
+    CHECK_EQ(error_of([&] { jsonn::parse_file(path.string()); }), "Cannot open file: " + path.string());
+}
+
+} // namespace
+
+int main() {
+    test_unterminated_string();
+    test_malformed();
+    test_double_range();
+    test_parallel_errors();
+    test_parse_file();
+    return check_result();
+}
@@ -0,0 +1,127 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Path lookups over Value and Document
+
+#include "check.h"
+#include "jsonn.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* json = R"({"items":[{"id":1},{"name":"x"},{"id":3}],"meta":{"a":{"id":4},"b":{"id":5}}})";
+
+void test_element_wildcards() {
+    jsonn::Value v = jsonn::parse(json);
+    jsonn::Document doc;
+    jsonn::Element root = doc.parse(json);
+
+    for (const char* p : {"$.items[*].id", "/items/*/id", "$.meta.*.id", "$.*[*].id", "$.items[*].missing", "$.items[1].name"}) {
+        jsonn::Path path(p);
+        // Wildcard lookups on an Element return the first match like on a Value
+        const jsonn::Value* expected = path.find(v);
+        std::optional<jsonn::Element> found;
+        CHECK_EQ(error_of([&] { found = path.find(root); }), std::string());
+        CHECK_EQ(bool(found), expected != nullptr);
+        if (found && expected) CHECK_EQ(jsonn::serialize(found->to_value()), jsonn::serialize(*expected));
+
+        std::vector<const jsonn::Value*> values;
+        path.find_all(v, values);
+        std::vector<jsonn::Element> elements;
+        path.find_all(root, elements);
+        CHECK_EQ(elements.size(), values.size());
+        for (size_t i = 0; i < elements.size() && i < values.size(); ++i) {
+            CHECK_EQ(jsonn::serialize(elements[i].to_value()), jsonn::serialize(*values[i]));
+        }
+    }
+
+    std::vector<jsonn::Element> ids;
+    jsonn::Path("$.items[*].id").find_all(root, ids);
+    CHECK_EQ(ids.size(), size_t(2));
+    if (ids.size() == 2) {
+        CHECK_EQ(ids[0].as_int(), int64_t(1));
+        CHECK_EQ(ids[1].as_int(), int64_t(3));
+    }
+}
+
+// extract() on the text, find() on the parsed Value and on the Document
+// all give the same answer, or all find nothing
+void check_same_match(const char* path, const char* json, const char* expected) {
+    jsonn::Path p(path);
+    jsonn::Value v = jsonn::parse(json);
+    jsonn::Document doc;
+    jsonn::Element root = doc.parse(json);
+    const jsonn::Value* found = p.find(v);
+    std::optional<jsonn::Element> element = p.find(root);
+    std::optional<jsonn::Value> extracted = p.extract(json);
+    if (!expected) {
+        CHECK(!found);
+        CHECK(!element);
+        CHECK(!extracted);
+        return;
+    }
+    CHECK(found && jsonn::serialize(*found) == expected);
+    CHECK(element && jsonn::serialize(element->to_value()) == expected);
+    CHECK(extracted && jsonn::serialize(*extracted) == expected);
+}
+
+void test_duplicate_keys() {
+    // The last of repeated keys counts, whichever API is asked
+    check_same_match("$.a", R"({"a":1,"a":2})", "2");
+    check_same_match("/a", R"({"a":1,"b":0,"a":[2]})", "[2]");
+    check_same_match("$.a.b", R"({"a":{"b":1},"a":{}})", nullptr);
+    check_same_match("$.a.b", R"({"a":{},"a":{"b":3}})", "3");
+    check_same_match("$.a[1]", R"({"a":[0,1],"c":{"a":5},"a":[0,9]})", "9");
+    check_same_match("$.k.a", R"({"k":{"a":1,"a":2},"k":{"a":3,"x":0,"a":4}})", "4");
+    // Wildcards take members in the order keys first appear, with their last values
+    check_same_match("$.*.a", R"({"x":{"a":1},"y":{"a":2},"x":{}})", "2");
+    check_same_match("$.*.a", R"({"x":{},"y":{"a":2},"x":{"a":1}})", "1");
+    check_same_match("$[*].a", R"([{"b":0},{"a":1,"a":5},{"a":2}])", "5");
+    check_same_match("$.missing", R"({"a":1})", nullptr);
+    check_same_match("$.a", R"([1,2])", nullptr);
+
+    // extract_all streams every match, repeated keys included
+    std::vector<std::string> all;
+    jsonn::Path("$.a").extract_all(R"({"a":1,"a":2})", [&](jsonn::Value&& v) { all.push_back(jsonn::serialize(v)); });
+    CHECK(all == std::vector<std::string>({"1", "2"}));
+
+    // The whole text is still checked
+    CHECK(!error_of([] { jsonn::Path("$.a").extract(R"({"a":1,"b":})"); }).empty());
+}
+
+} // namespace
+
+int main() {
+    test_element_wildcards();
+    test_duplicate_keys();
+    return check_result();
+}
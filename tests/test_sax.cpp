@@ -0,0 +1,185 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// parse_sax and StreamParser follow the same ParseOptions
+
+#include "check.h"
+#include "jsonn.h"
+#include <string>
+
+namespace {
+
+struct Strings : jsonn::Handler {
+    std::string last;
+    void string_value(std::string_view s) override { last.assign(s); }
+};
+
+std::string stream(std::string_view json, const jsonn::ParseOptions& options, Strings& h) {
+    jsonn::StreamParser p(h, options);
+    return error_of([&] {
+        // Byte by byte, so every token is split across chunks
+        for (char c : json) p.feed(std::string_view(&c, 1));
+        p.finish();
+    });
+}
+
+// Writes every event down, so two event sequences can be compared
+struct Recorder : jsonn::Handler {
+    std::string log;
+    void null_value() override { log += "null "; }
+    void bool_value(bool b) override { log += b ? "true " : "false "; }
+    void int_value(int64_t i) override { log += "int:" + std::to_string(i) + " "; }
+    void uint_value(uint64_t u) override { log += "uint:" + std::to_string(u) + " "; }
+    void double_value(double d) override { log += "double:" + jsonn::serialize(jsonn::Value(d)) + " "; }
+    void string_value(std::string_view s) override { log += "string:" + std::string(s) + " "; }
+    void start_object() override { log += "{ "; }
+    void key(std::string_view k) override { log += "key:" + std::string(k) + " "; }
+    void end_object() override { log += "} "; }
+    void start_array() override { log += "[ "; }
+    void end_array() override { log += "] "; }
+};
+
+// Every kind of token, with escapes, a surrogate pair, exponents and
+// literals for the chunk boundaries to fall into
+const std::string tokens = "{\"k\\u00e9y\" : [true,false , null,-12.5e-3,1E+2,0,-0.0,18446744073709551615,"
+                           "-9223372036854775808, \"a\\\"b\\\\c\\ud83d\\ude00\\n\",{},[ ],[[]]],\r\n"
+                           "\t\"caf\xc3\xa9\":\"\xf0\x9f\x98\x80\", \"\":\"\" , \"n\":{\"m\":123456789}}";
+
+void test_chunk_boundaries() {
+    Recorder whole;
+    jsonn::parse_sax(tokens, whole);
+    CHECK(whole.log.find("string:a\"b\\c\xf0\x9f\x98\x80\n") != std::string::npos);
+    CHECK(whole.log.find("double:-0.0125 double:100.0 int:0 double:-0.0 uint:18446744073709551615") != std::string::npos);
+
+    // Split in two at every offset
+    for (size_t i = 0; i <= tokens.size(); ++i) {
+        Recorder r;
+        jsonn::StreamParser p(r);
+        std::string error = error_of([&] {
+            p.feed(std::string_view(tokens).substr(0, i));
+            p.feed(std::string_view(tokens).substr(i));
+            p.finish();
+        });
+        CHECK_EQ(error, std::string());
+        CHECK_EQ(r.log, whole.log);
+    }
+    // Fed in pieces of every small size, 1 byte included
+    for (size_t size = 1; size <= 8; ++size) {
+        Recorder r;
+        jsonn::StreamParser p(r);
+        for (size_t i = 0; i < tokens.size(); i += size) p.feed(std::string_view(tokens).substr(i, size));
+        p.finish();
+        CHECK_EQ(r.log, whole.log);
+        CHECK_EQ(p.position(), tokens.size());
+    }
+}
+
+void test_truncated() {
+    // Every proper prefix is incomplete: fed fine, refused by finish()
+    for (size_t n = 0; n < tokens.size(); ++n) {
+        Recorder r;
+        jsonn::StreamParser p(r);
+        for (size_t i = 0; i < n; ++i) p.feed(std::string_view(&tokens[i], 1));
+        CHECK(!error_of([&] { p.finish(); }).empty());
+    }
+
+    // Scalar documents end with the input, so finish() completes them
+    for (const char* json : {"123", "-1.5e10", "true", "null", "\"a\\u0041\""}) {
+        Recorder whole, r;
+        jsonn::parse_sax(json, whole);
+        jsonn::StreamParser p(r);
+        for (const char* c = json; *c; ++c) p.feed(std::string_view(c, 1));
+        p.finish();
+        CHECK_EQ(r.log, whole.log);
+    }
+    for (const char* json : {"-", "1.", "1e", "1e+", "tru", "nul", "\"ab", "\"a\\", "\"\\u00", "\"\\ud83d\\ude0"}) {
+        Recorder r;
+        jsonn::StreamParser p(r);
+        for (const char* c = json; *c; ++c) p.feed(std::string_view(c, 1));
+        CHECK(!error_of([&] { p.finish(); }).empty());
+    }
+
+    // reset() starts over after an incomplete document
+    Recorder r;
+    jsonn::StreamParser p(r);
+    p.feed("[1,");
+    p.reset();
+    p.feed("[2]");
+    p.finish();
+    CHECK_EQ(r.log, std::string("[ int:1 [ int:2 ] "));
+}
+
+void test_validate_utf8() {
+    const std::string bad = "[\"a\xff\"]";
+    jsonn::ParseOptions off;
+    off.validate_utf8 = false;
+    Strings h;
+
+    CHECK(!error_of([&] { jsonn::parse_sax(bad, h); }).empty());
+    CHECK(!stream(bad, jsonn::ParseOptions{}, h).empty());
+
+    h.last.clear();
+    CHECK_EQ(error_of([&] { jsonn::parse_sax(bad, h, off); }), std::string());
+    CHECK_EQ(h.last, std::string("a\xff"));
+    h.last.clear();
+    CHECK_EQ(stream(bad, off, h), std::string());
+    CHECK_EQ(h.last, std::string("a\xff"));
+}
+
+void test_max_depth() {
+    // Deep enough to overflow the stack of a recursive parser without a limit
+    const std::string deep(200000, '[');
+    jsonn::Handler h;
+    std::string expected = "Nesting too deep at position 1024";
+    CHECK_EQ(error_of([&] { jsonn::parse_sax(deep, h); }), expected);
+    jsonn::ParseOptions indexed;
+    indexed.mode = jsonn::ParseMode::indexed;
+    CHECK_EQ(error_of([&] { jsonn::parse_sax(deep, h, indexed); }), expected);
+    CHECK_EQ(error_of([&] { jsonn::parse(deep); }), expected);
+    Strings s;
+    CHECK_EQ(stream(deep, jsonn::ParseOptions{}, s), expected);
+
+    jsonn::ParseOptions shallow;
+    shallow.max_depth = 2;
+    CHECK_EQ(error_of([&] { jsonn::parse_sax("[[1]]", h, shallow); }), std::string());
+    CHECK_EQ(error_of([&] { jsonn::parse_sax("[[[1]]]", h, shallow); }), std::string("Nesting too deep at position 2"));
+    CHECK_EQ(stream("[[[1]]]", shallow, s), std::string("Nesting too deep at position 2"));
+}
+
+} // namespace
+
+int main() {
+    test_chunk_boundaries();
+    test_truncated();
+    test_validate_utf8();
+    test_max_depth();
+    return check_result();
+}
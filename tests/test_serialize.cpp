@@ -0,0 +1,250 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Serializer output: string escaping, numbers and the output buffers
+
+#include "check.h"
+#include "jsonn.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace {
+
+void test_control_characters() {
+    std::string s;
+    for (int c = 0; c < 0x20; ++c) s.push_back(static_cast<char>(c));
+    s += "\"\\/\x7f";
+    std::string out = jsonn::serialize(jsonn::Value(s));
+    CHECK_EQ(out, std::string("\"\\u0000\\u0001\\u0002\\u0003\\u0004\\u0005\\u0006\\u0007\\b\\t\\n\\u000b\\f\\r\\u000e\\u000f"
+                              "\\u0010\\u0011\\u0012\\u0013\\u0014\\u0015\\u0016\\u0017\\u0018\\u0019\\u001a\\u001b\\u001c\\u001d\\u001e\\u001f"
+                              "\\\"\\\\/\x7f\""));
+    CHECK_EQ(jsonn::parse(out).as_string(), s);
+
+    // Runs between escapes are copied whole, UTF-8 passes through as is
+    std::string text = "caf\xc3\xa9 \xf0\x9f\x98\x80\nnext line";
+    CHECK_EQ(jsonn::serialize(jsonn::Value(text)), "\"" + std::string("caf\xc3\xa9 \xf0\x9f\x98\x80\\nnext line") + "\"");
+    CHECK_EQ(jsonn::parse(jsonn::serialize(jsonn::Value(text))).as_string(), text);
+}
+
+// Serialized text of d, checked to parse back to the same bits
+std::string round_trip(double d) {
+    std::string text = jsonn::serialize(jsonn::Value(d));
+    jsonn::Value back = jsonn::parse(text);
+    CHECK(!back.is_int());
+    CHECK_EQ(std::bit_cast<uint64_t>(back.as_number()), std::bit_cast<uint64_t>(d));
+    return text;
+}
+
+void test_shortest_doubles() {
+    CHECK_EQ(round_trip(0.1), std::string("0.1"));
+    CHECK_EQ(round_trip(1e300), std::string("1e+300"));
+    CHECK_EQ(round_trip(-0.0), std::string("-0.0"));
+    CHECK_EQ(round_trip(5e-324), std::string("5e-324"));
+    CHECK_EQ(round_trip(2.2250738585072009e-308), std::string("2.225073858507201e-308"));
+    // Integral doubles stay doubles
+    CHECK_EQ(round_trip(1.0), std::string("1.0"));
+    CHECK_EQ(round_trip(-42.0), std::string("-42.0"));
+    round_trip(std::numeric_limits<double>::max());
+    round_trip(std::numeric_limits<double>::min());
+    round_trip(1.0 / 3);
+    for (double d = 1e-310; d < 1e300; d *= 7.3) round_trip(d);
+
+    // JSON has no NaN or infinity
+    CHECK_EQ(jsonn::serialize(jsonn::Value(std::numeric_limits<double>::infinity())), std::string("null"));
+    CHECK_EQ(jsonn::serialize(jsonn::Value(std::nan(""))), std::string("null"));
+}
+
+void test_integers() {
+    jsonn::Array a;
+    a.push_back(INT64_MIN);
+    a.push_back(INT64_MAX);
+    a.push_back(UINT64_MAX);
+    CHECK_EQ(jsonn::serialize(jsonn::Value(std::move(a))), std::string("[-9223372036854775808,9223372036854775807,18446744073709551615]"));
+}
+
+void test_buffers() {
+    jsonn::Value v = jsonn::parse(R"({"a":[1,2.5,"x"],"b":null,"c":true})");
+    std::string expected = R"({"a":[1,2.5,"x"],"b":null,"c":true})";
+    CHECK_EQ(jsonn::serialize(v), expected);
+
+    // serialize_to appends, Writer keeps its buffer across clear()
+    std::string out = "prefix:";
+    jsonn::serialize_to(out, v);
+    CHECK_EQ(out, "prefix:" + expected);
+    jsonn::Writer w;
+    w.write(v);
+    CHECK_EQ(w.str(), expected);
+    w.clear();
+    w.write(jsonn::Value(1));
+    CHECK_EQ(w.str(), std::string("1"));
+}
+
+std::string with(const jsonn::Value& v, const jsonn::SerializeOptions& options) {
+    return jsonn::serialize(v, options);
+}
+
+jsonn::SerializeOptions canonical() {
+    jsonn::SerializeOptions options;
+    options.canonical = true;
+    return options;
+}
+
+std::string jcs_number(double d) {
+    return with(jsonn::Value(d), canonical());
+}
+
+void test_canonical_numbers() {
+    // ECMAScript Number::toString: plain notation from 1e-6 up to 1e21
+    CHECK_EQ(jcs_number(1e21), std::string("1e+21"));
+    CHECK_EQ(jcs_number(1e20), std::string("100000000000000000000"));
+    CHECK_EQ(jcs_number(1e-7), std::string("1e-7"));
+    CHECK_EQ(jcs_number(1e-6), std::string("0.000001"));
+    CHECK_EQ(jcs_number(-0.0), std::string("0"));
+    CHECK_EQ(jcs_number(0.1), std::string("0.1"));
+    CHECK_EQ(jcs_number(5e-324), std::string("5e-324"));
+    CHECK_EQ(jcs_number(-1.5e300), std::string("-1.5e+300"));
+    CHECK_EQ(jcs_number(1.0), std::string("1"));
+    CHECK_EQ(jcs_number(123.456), std::string("123.456"));
+    // Integers are numbers a double holds; beyond 2^53 they are rounded
+    CHECK_EQ(with(jsonn::Value(int64_t(9007199254740993)), canonical()), std::string("9007199254740992"));
+    CHECK_EQ(with(jsonn::Value(int64_t(-9007199254740992)), canonical()), std::string("-9007199254740992"));
+    CHECK_EQ(with(jsonn::Value(UINT64_MAX), canonical()), std::string("18446744073709552000"));
+
+    // No canonical form for NaN or infinity, in any position
+    CHECK(!error_of([] { jcs_number(std::nan("")); }).empty());
+    CHECK(!error_of([] { jcs_number(-std::numeric_limits<double>::infinity()); }).empty());
+    jsonn::Object o;
+    o["x"] = jsonn::Array{1, std::numeric_limits<double>::infinity()};
+    CHECK(!error_of([&] { with(jsonn::Value(std::move(o)), canonical()); }).empty());
+}
+
+void test_canonical_keys() {
+    // U+1F600 is the surrogate pair D83D DE00 in UTF-16, which sorts before
+    // U+E000 and U+FFFD though its UTF-8 bytes sort after theirs
+    std::string emoji = "\xf0\x9f\x98\x80";
+    std::string private_use = "\xee\x80\x80";
+    std::string replacement = "\xef\xbf\xbd";
+    jsonn::Object o;
+    o[replacement] = 1;
+    o[emoji] = 2;
+    o[private_use] = 3;
+    o["z"] = 4;
+    o["\xc3\xa9"] = 5;
+    o["a"] = 6;
+    o["ab"] = 7;
+    jsonn::Value v(std::move(o));
+    CHECK_EQ(with(v, canonical()), "{\"a\":6,\"ab\":7,\"z\":4,\"\xc3\xa9\":5,\"" + emoji + "\":2,\"" + private_use + "\":3,\"" + replacement + "\":1}");
+
+    // sort_keys alone orders by bytes
+    jsonn::SerializeOptions sorted;
+    sorted.sort_keys = true;
+    CHECK_EQ(with(v, sorted), "{\"a\":6,\"ab\":7,\"z\":4,\"\xc3\xa9\":5,\"" + private_use + "\":3,\"" + replacement + "\":1,\"" + emoji + "\":2}");
+
+    // Canonical output overrides the other options
+    jsonn::SerializeOptions mixed = canonical();
+    mixed.indent = 4;
+    mixed.ascii_only = true;
+    mixed.precision = 3;
+    jsonn::Value nested = jsonn::parse(R"({"b":[1.23456,"é"],"a":{}})");
+    CHECK_EQ(with(nested, mixed), "{\"a\":{},\"b\":[1.23456,\"\xc3\xa9\"]}");
+}
+
+void test_pretty() {
+    jsonn::SerializeOptions pretty;
+    pretty.indent = 2;
+    CHECK_EQ(with(jsonn::parse("[]"), pretty), std::string("[]"));
+    CHECK_EQ(with(jsonn::parse("{}"), pretty), std::string("{}"));
+    CHECK_EQ(with(jsonn::parse("[[],{}]"), pretty), std::string("[\n  [],\n  {}\n]"));
+    CHECK_EQ(with(jsonn::parse(R"({"a":[1,{"b":null}],"c":{}})"), pretty),
+             std::string("{\n  \"a\": [\n    1,\n    {\n      \"b\": null\n    }\n  ],\n  \"c\": {}\n}"));
+    pretty.indent = 1;
+    CHECK_EQ(with(jsonn::parse("[[1]]"), pretty), std::string("[\n [\n  1\n ]\n]"));
+    CHECK_EQ(with(jsonn::Value(5), pretty), std::string("5"));
+
+    // Pretty output parses back to the same value
+    jsonn::Value v = jsonn::parse(R"({"x":[[],[[]],{"y":{"z":[true]}}],"s":"t"})");
+    pretty.indent = 3;
+    CHECK(jsonn::parse(with(v, pretty)) == v);
+}
+
+void test_ascii_only() {
+    jsonn::SerializeOptions ascii;
+    ascii.ascii_only = true;
+    // Above U+FFFF as a surrogate pair, below it as one escape
+    CHECK_EQ(with(jsonn::Value("\xf0\x9f\x98\x80"), ascii), std::string("\"\\ud83d\\ude00\""));
+    CHECK_EQ(with(jsonn::Value("\xf4\x8f\xbf\xbf"), ascii), std::string("\"\\udbff\\udfff\""));
+    CHECK_EQ(with(jsonn::Value("\xf0\x90\x80\x80"), ascii), std::string("\"\\ud800\\udc00\""));
+    CHECK_EQ(with(jsonn::Value("caf\xc3\xa9 \xef\xbf\xbd\n"), ascii), std::string("\"caf\\u00e9 \\ufffd\\n\""));
+    std::string mixed = "a\xf0\x9f\x98\x80" "b\xe2\x82\xac";
+    std::string out = with(jsonn::Value(mixed), ascii);
+    for (char c : out) CHECK(static_cast<unsigned char>(c) < 0x80);
+    CHECK_EQ(jsonn::parse(out).as_string(), mixed);
+
+    // Keys are escaped too
+    jsonn::Object o;
+    o["\xf0\x9f\x98\x80"] = 1;
+    CHECK_EQ(with(jsonn::Value(std::move(o)), ascii), std::string("{\"\\ud83d\\ude00\":1}"));
+}
+
+void test_precision() {
+    jsonn::SerializeOptions options;
+    options.precision = 3;
+    CHECK_EQ(with(jsonn::Value(3.14159), options), std::string("3.14"));
+    CHECK_EQ(with(jsonn::Value(2.0), options), std::string("2.0"));
+    CHECK_EQ(with(jsonn::Value(1234567.0), options), std::string("1.23e+06"));
+    CHECK_EQ(with(jsonn::Value(-0.000123456), options), std::string("-0.000123"));
+    // Integers keep all their digits
+    CHECK_EQ(with(jsonn::Value(123456789), options), std::string("123456789"));
+    CHECK_EQ(with(jsonn::Value(std::nan("")), options), std::string("null"));
+    // More than 17 digits adds nothing
+    options.precision = 40;
+    CHECK_EQ(with(jsonn::Value(0.1), options), std::string("0.10000000000000001"));
+    options.precision = 1;
+    CHECK_EQ(with(jsonn::parse("[0.25,97.0]"), options), std::string("[0.2,1e+02]"));
+}
+
+} // namespace
+
+int main() {
+    test_control_characters();
+    test_shortest_doubles();
+    test_integers();
+    test_buffers();
+    test_canonical_numbers();
+    test_canonical_keys();
+    test_pretty();
+    test_ascii_only();
+    test_precision();
+    return check_result();
+}
@@ -0,0 +1,190 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Instrumentation counters and the stats hook; with the stats option off,
+// checks that nothing is counted
+
+#include "check.h"
+#include "jsonn.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct HookCall {
+    std::string api;
+    jsonn::Stats stats;
+};
+
+std::vector<HookCall> hook_calls;
+
+void record_hook() {
+    hook_calls.clear();
+    jsonn::set_stats_hook([](const char* api, const jsonn::Stats& call) { hook_calls.push_back({api, call}); });
+}
+
+void test_disabled() {
+    record_hook();
+    jsonn::reset_stats();
+    jsonn::parse(R"({"a":[1,2.5,"s",true,null]})");
+    jsonn::serialize(jsonn::parse("[1]"));
+    jsonn::Stats s = jsonn::stats();
+    CHECK_EQ(s.calls, uint64_t(0));
+    CHECK_EQ(s.bytes_parsed, uint64_t(0));
+    CHECK(hook_calls.empty());
+    jsonn::set_stats_hook(nullptr);
+}
+
+void test_parse_counters() {
+    record_hook();
+    jsonn::reset_stats();
+    std::string json = R"({"a":[1,-2,2.5,"s",true,false,null],"b":{"c":[]}})";
+    jsonn::parse(json);
+
+    jsonn::Stats s = jsonn::stats();
+    CHECK_EQ(s.calls, uint64_t(1));
+    CHECK_EQ(s.bytes_parsed, uint64_t(json.size()));
+    CHECK_EQ(s.integers, uint64_t(2));
+    CHECK_EQ(s.doubles, uint64_t(1));
+    CHECK_EQ(s.strings, uint64_t(1));
+    CHECK_EQ(s.bools, uint64_t(2));
+    CHECK_EQ(s.nulls, uint64_t(1));
+    CHECK_EQ(s.arrays, uint64_t(2));
+    CHECK_EQ(s.objects, uint64_t(2));
+    CHECK_EQ(s.max_depth, uint32_t(3));
+    CHECK(s.parse_time > 0);
+
+    CHECK_EQ(hook_calls.size(), size_t(1));
+    CHECK_EQ(hook_calls[0].api, std::string("parse"));
+    CHECK_EQ(hook_calls[0].stats.integers, uint64_t(2));
+
+    // Totals accumulate until reset
+    jsonn::parse("[1]");
+    CHECK_EQ(jsonn::stats().calls, uint64_t(2));
+    CHECK_EQ(jsonn::stats().integers, uint64_t(3));
+    jsonn::reset_stats();
+    CHECK_EQ(jsonn::stats().calls, uint64_t(0));
+    jsonn::set_stats_hook(nullptr);
+}
+
+void test_serialize_counters() {
+    record_hook();
+    jsonn::reset_stats();
+    jsonn::Value v = jsonn::parse(R"({"key":[1,2,3]})");
+    jsonn::reset_stats();
+    hook_calls.clear();
+
+    // Appending counts only the bytes written by the call
+    std::string out = "prefix";
+    jsonn::serialize_to(out, v);
+    CHECK_EQ(jsonn::stats().bytes_serialized, uint64_t(out.size() - 6));
+    jsonn::SerializeOptions pretty;
+    pretty.indent = 2;
+    size_t before = out.size();
+    jsonn::serialize_to(out, v, pretty);
+    CHECK_EQ(jsonn::stats().bytes_serialized, uint64_t(out.size() - 6));
+    CHECK_EQ(hook_calls.back().stats.bytes_serialized, uint64_t(out.size() - before));
+    CHECK_EQ(hook_calls.back().api, std::string("serialize_to"));
+
+    jsonn::reset_stats();
+    std::string s = jsonn::serialize(v);
+    CHECK_EQ(jsonn::stats().bytes_serialized, uint64_t(s.size()));
+    CHECK_EQ(jsonn::stats().calls, uint64_t(1));
+    jsonn::set_stats_hook(nullptr);
+}
+
+void test_parallel_counters() {
+    record_hook();
+    std::string jsonl;
+    for (int i = 0; i < 2000; ++i) jsonl += R"({"id":)" + std::to_string(i) + R"(,"tags":["x","y"]})" "\n";
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 4096;
+
+    jsonn::reset_stats();
+    hook_calls.clear();
+    std::vector<jsonn::Value> records = jsonn::parse_jsonl(jsonl, options);
+    jsonn::Stats s = jsonn::stats();
+    CHECK_EQ(records.size(), size_t(2000));
+    // Nested parse calls inside the tasks add to the one top-level call
+    CHECK_EQ(s.calls, uint64_t(1));
+    CHECK_EQ(hook_calls.size(), size_t(1));
+    CHECK_EQ(hook_calls[0].api, std::string("parse_jsonl"));
+    CHECK_EQ(s.bytes_parsed, uint64_t(jsonl.size() - 2000));
+    CHECK_EQ(s.integers, uint64_t(2000));
+    CHECK_EQ(s.strings, uint64_t(4000));
+    CHECK_EQ(s.objects, uint64_t(2000));
+    CHECK(s.tasks > 1);
+    CHECK(s.task_time > 0 && s.max_task_time <= s.task_time);
+
+    jsonn::reset_stats();
+    std::string out = jsonn::serialize_jsonl(records, options);
+    CHECK_EQ(jsonn::stats().bytes_serialized, uint64_t(out.size() - 2000));
+    CHECK_EQ(jsonn::stats().calls, uint64_t(1));
+    jsonn::set_stats_hook(nullptr);
+}
+
+void test_concurrent_calls() {
+    // Calls on different threads keep their own counters and all reach the totals
+    jsonn::reset_stats();
+    std::string jsonl;
+    for (int i = 0; i < 500; ++i) jsonl += "[1,2]\n";
+    jsonn::ParallelOptions options;
+    options.serial_threshold = 0;
+    options.chunk_size = 512;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int k = 0; k < 10; ++k) jsonn::parse_jsonl(jsonl, options);
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    jsonn::Stats s = jsonn::stats();
+    CHECK_EQ(s.calls, uint64_t(40));
+    CHECK_EQ(s.integers, uint64_t(40 * 1000));
+    CHECK_EQ(s.arrays, uint64_t(40 * 500));
+    CHECK_EQ(s.bytes_parsed, uint64_t(40 * (jsonl.size() - 500)));
+}
+
+} // namespace
+
+int main() {
+    if (!jsonn::stats_enabled()) {
+        test_disabled();
+        return check_result();
+    }
+    test_parse_counters();
+    test_serialize_counters();
+    test_parallel_counters();
+    test_concurrent_calls();
+    return check_result();
+}
@@ -0,0 +1,134 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// String decoding: \u escapes with surrogate pairs and UTF-8 validation,
+// checked in every parser with validate_utf8 on and off
+
+#include "check.h"
+#include "jsonn.h"
+#include <string>
+
+namespace {
+
+jsonn::ParseOptions options(jsonn::ParseMode mode, bool validate) {
+    jsonn::ParseOptions o;
+    o.mode = mode;
+    o.validate_utf8 = validate;
+    return o;
+}
+
+// Parses json with every parser and checks they agree on the error, or on
+// the decoded string when expected_error is empty
+void check_string(const std::string& json, bool validate, const std::string& expected_error, const std::string& expected = "") {
+    for (jsonn::ParseMode mode : {jsonn::ParseMode::scalar, jsonn::ParseMode::indexed}) {
+        jsonn::ParseOptions o = options(mode, validate);
+        jsonn::Value v;
+        CHECK_EQ(error_of([&] { v = jsonn::parse(json, o); }), expected_error);
+        jsonn::Document doc;
+        std::string doc_value;
+        CHECK_EQ(error_of([&] { doc_value = std::string(doc.parse(json, o).as_string()); }), expected_error);
+        if (expected_error.empty()) {
+            CHECK_EQ(v.as_string(), expected);
+            CHECK_EQ(doc_value, expected);
+        }
+    }
+}
+
+void test_surrogates() {
+    for (bool validate : {true, false}) {
+        check_string(R"("\ud83d\ude00")", validate, "", "\xF0\x9F\x98\x80");
+        check_string(R"("x\ud83d\ude00y\n")", validate, "", "x\xF0\x9F\x98\x80y\n");
+        // Escapes are checked whatever validate_utf8 says
+        check_string(R"("\ud83d")", validate, "Unpaired surrogate at position 1");
+        check_string(R"("\ud83dx")", validate, "Unpaired surrogate at position 1");
+        check_string(R"("\ud83dA")", validate, "Unpaired surrogate at position 1");
+        check_string(R"("ab\ude00")", validate, "Unpaired surrogate at position 3");
+    }
+}
+
+void test_utf8() {
+    struct Case {
+        std::string body;
+        size_t bad; // position of the first bad byte in the JSON text
+    };
+    const Case cases[] = {
+        {"\xC0\xAF", 1},             // overlong '/'
+        {"\xE0\x80\xAF", 1},         // overlong, three bytes
+        {"\xF0\x80\x80\xAF", 1},     // overlong, four bytes
+        {"ab\xE2\x82", 3},           // truncated at the end of the string
+        {"\xE2\x82x", 1},            // truncated before ASCII
+        {"\xF0\x9F\x98", 1},         // truncated four byte sequence
+        {"a\\n\xC0\xAF", 4},         // after an escape
+    };
+    for (const Case& c : cases) {
+        std::string json = "\"" + c.body + "\"";
+        check_string(json, true, "Invalid UTF-8 at position " + std::to_string(c.bad));
+        // Without validation the bytes pass through as they are
+        std::string raw = c.body;
+        if (raw.rfind("a\\n", 0) == 0) raw.replace(1, 2, "\n");
+        check_string(json, false, "", raw);
+    }
+    check_string("\"\xE2\x82\xAC \xF0\x9F\x98\x80\"", true, "", "\xE2\x82\xAC \xF0\x9F\x98\x80");
+}
+
+void test_control_characters() {
+    for (bool validate : {true, false}) {
+        for (int c = 0; c < 0x20; ++c) {
+            std::string ctl(1, static_cast<char>(c));
+            check_string("\"ab" + ctl + "cd\"", validate, "Unescaped control character at position 3");
+            // Past the 16-byte blocks of the bulk scan, and after an escape
+            check_string("\"" + std::string(40, 'a') + ctl + "\"", validate, "Unescaped control character at position 41");
+            check_string("\"\\n" + std::string(20, 'a') + ctl + "\"", validate, "Unescaped control character at position 23");
+        }
+        // A string cut off after one is unterminated, as the index reports it
+        check_string("\"ab\ncd", validate, "Unterminated string at position 0");
+        check_string("\"\\tab\ncd", validate, "Unterminated string at position 0");
+        // Escaped forms and DEL are fine
+        check_string(R"("\u0000\u001f\t")", validate, "", std::string("\0\x1f\t", 3));
+        check_string("\"a\x7f\"", validate, "", "a\x7f");
+    }
+
+    // Keys are checked too
+    CHECK_EQ(error_of([] { jsonn::parse("{\"a\tb\":1}"); }), std::string("Unescaped control character at position 3"));
+    jsonn::Handler h;
+    CHECK_EQ(error_of([&] { jsonn::parse_sax("[\"a\nb\"]", h); }), std::string("Unescaped control character at position 3"));
+    jsonn::StreamParser p(h);
+    CHECK_EQ(error_of([&] { p.feed("[\"a\nb\"]"); p.finish(); }), std::string("Unescaped control character at position 3"));
+}
+
+} // namespace
+
+int main() {
+    test_surrogates();
+    test_utf8();
+    test_control_characters();
+    return check_result();
+}
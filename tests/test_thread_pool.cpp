@@ -0,0 +1,172 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ThreadPool and the parallel options of the JSONL functions
+
+#include "check.h"
+#include "jsonn.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void test_every_index_once() {
+    jsonn::ThreadPool pool(4);
+    CHECK_EQ(pool.size(), size_t(4));
+    for (size_t count : {0, 1, 2, 3, 5, 64, 1000, 10007}) {
+        for (int round = 0; round < 3; ++round) {
+            std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[count + 1]());
+            pool.run(count, [&](size_t i) { runs[i].fetch_add(1); });
+            size_t wrong = 0;
+            for (size_t i = 0; i < count; ++i) wrong += runs[i].load() != 1;
+            CHECK_EQ(wrong, size_t(0));
+        }
+    }
+
+    // Uneven tasks get stolen and still run once each
+    std::vector<std::atomic<int>> runs(200);
+    pool.run(runs.size(), [&](size_t i) {
+        if (i < 4) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        runs[i].fetch_add(1);
+    });
+    for (auto& r : runs) CHECK_EQ(r.load(), 1);
+}
+
+void test_concurrent_runs() {
+    // Two threads share the pool, their runs never overlap
+    jsonn::ThreadPool pool(4);
+    std::atomic<int> in_flight[2] = {0, 0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> total{0};
+    auto caller = [&](int self) {
+        for (int round = 0; round < 50; ++round) {
+            pool.run(64, [&](size_t) {
+                in_flight[self].fetch_add(1);
+                if (in_flight[1 - self].load()) overlaps.fetch_add(1);
+                total.fetch_add(1);
+                in_flight[self].fetch_sub(1);
+            });
+        }
+    };
+    std::thread a(caller, 0), b(caller, 1);
+    a.join();
+    b.join();
+    CHECK_EQ(overlaps.load(), 0);
+    CHECK_EQ(total.load(), 2 * 50 * 64);
+}
+
+void test_exceptions() {
+    jsonn::ThreadPool pool(4);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::atomic<int>> runs(500);
+        std::string error = error_of([&] {
+            pool.run(runs.size(), [&](size_t i) {
+                runs[i].fetch_add(1);
+                if (i % 100 == 7) throw std::runtime_error("task " + std::to_string(i));
+            });
+        });
+        // One of the failures comes back once every task has run
+        CHECK(error.rfind("task ", 0) == 0);
+        size_t wrong = 0;
+        for (auto& r : runs) wrong += r.load() != 1;
+        CHECK_EQ(wrong, size_t(0));
+    }
+    // The pool is still usable
+    std::atomic<int> sum{0};
+    pool.run(10, [&](size_t i) { sum.fetch_add(static_cast<int>(i)); });
+    CHECK_EQ(sum.load(), 45);
+}
+
+std::string records(size_t n) {
+    std::string jsonl;
+    for (size_t i = 0; i < n; ++i) jsonl += R"({"id":)" + std::to_string(i) + R"(,"name":"record"})" + "\n";
+    return jsonl;
+}
+
+void test_options() {
+    // A pool held by another run blocks the JSONL functions that use it
+    jsonn::ThreadPool pool(2);
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    std::thread holder([&] {
+        pool.run(2, [&](size_t) {
+            started = true;
+            while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    });
+    while (!started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    const std::string jsonl = records(1000);
+    jsonn::ParallelOptions options;
+    options.pool = &pool;
+    options.chunk_size = 1024;
+
+    // Below serial_threshold the calling thread parses on its own
+    options.serial_threshold = jsonl.size() + 1;
+    CHECK_EQ(jsonn::parse_jsonl(jsonl, options).size(), size_t(1000));
+
+    // Above it, the work waits for the named pool
+    options.serial_threshold = 0;
+    auto parsed = std::async(std::launch::async, [&] { return jsonn::parse_jsonl(jsonl, options).size(); });
+    CHECK(parsed.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+    release = true;
+    CHECK_EQ(parsed.get(), size_t(1000));
+    holder.join();
+
+    // An executor takes the place of any pool
+    size_t calls = 0;
+    size_t tasks = 0;
+    options.pool = nullptr;
+    options.executor = [&](size_t count, const std::function<void(size_t)>& task) {
+        ++calls;
+        tasks += count;
+        for (size_t i = 0; i < count; ++i) task(i);
+    };
+    CHECK(jsonn::parse_jsonl(jsonl, options) == jsonn::parse_jsonl(jsonl));
+    CHECK_EQ(calls, size_t(1));
+    CHECK(tasks > 1);
+}
+
+} // namespace
+
+int main() {
+    test_every_index_once();
+    test_concurrent_runs();
+    test_exceptions();
+    test_options();
+    return check_result();
+}
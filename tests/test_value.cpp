@@ -0,0 +1,170 @@
+/*
+    jsonn - minimalist C++ library for json
+    Copyright (c) 2025 Aleksander Płomiński
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice,
+       this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+    3. Neither the name of the author nor the names of its contributors may be
+       used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Value ownership transfer and the safe getters
+
+#include "check.h"
+#include "jsonn.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> keys_of(const jsonn::Object& o) {
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : o) keys.push_back(key);
+    return keys;
+}
+
+void test_release() {
+    jsonn::Value doc = jsonn::parse(R"({"a":[1,2,3],"b":{"c":"text"},"d":4})");
+    const jsonn::Value* items = &doc["a"].as_array()[0];
+
+    // The subtree comes out without a copy and null stays behind
+    jsonn::Value a = doc["a"].release();
+    CHECK(doc["a"].is_null());
+    CHECK(a == jsonn::parse("[1,2,3]"));
+    CHECK_EQ(&a.as_array()[0], items);
+    CHECK(keys_of(doc.as_object()) == std::vector<std::string>({"a", "b", "d"}));
+
+    jsonn::Value whole = doc.release();
+    CHECK(doc.is_null());
+    CHECK(whole == jsonn::parse(R"({"a":null,"b":{"c":"text"},"d":4})"));
+    CHECK(jsonn::Value().release().is_null());
+}
+
+void test_move_construction() {
+    // Containers and strings are moved in, leaving their sources empty
+    jsonn::Array arr{1, "two", 3.0};
+    const jsonn::Value* first = arr.data();
+    jsonn::Value from_array(std::move(arr));
+    CHECK(arr.empty());
+    CHECK_EQ(from_array.as_array().data(), first);
+
+    jsonn::Object obj;
+    obj["k"] = "v";
+    jsonn::Value from_object(std::move(obj));
+    CHECK(obj.empty());
+    CHECK_EQ(obj.size(), size_t(0));
+    CHECK(obj.begin() == obj.end());
+    CHECK_EQ(from_object["k"].as_string(), std::string("v"));
+
+    std::string s(100, 'x');
+    const char* chars = s.data();
+    jsonn::Value from_string(std::move(s));
+    CHECK(s.empty());
+    CHECK_EQ(from_string.as_string().data(), chars);
+}
+
+void test_push_back_and_insert() {
+    jsonn::Value v = 5;
+    v.push_back(1);
+    v.push_back(jsonn::parse(R"({"x":1})"));
+    CHECK(v == jsonn::parse(R"([1,{"x":1}])"));
+
+    jsonn::Value o = "not an object";
+    jsonn::Value& inserted = o.insert("a", jsonn::Array{1, 2});
+    inserted.push_back(3);
+    o.insert("b", true);
+    o.insert("a", o["a"].release());
+    CHECK(o == jsonn::parse(R"({"a":[1,2,3],"b":true})"));
+    CHECK(keys_of(o.as_object()) == std::vector<std::string>({"a", "b"}));
+
+    // Moving a released value on leaves null behind at every step
+    jsonn::Value source = jsonn::parse(R"({"payload":{"big":[1,2,3]}})");
+    jsonn::Value target;
+    target.insert("moved", source["payload"].release());
+    CHECK(source["payload"].is_null());
+    CHECK(target["moved"]["big"] == jsonn::parse("[1,2,3]"));
+}
+
+void test_object_extract() {
+    jsonn::Object o;
+    for (int i = 0; i < 20; ++i) o.insert_or_assign("k" + std::to_string(i), jsonn::Array{i});
+    auto v = o.extract("k5");
+    CHECK(v && *v == jsonn::Value(jsonn::Array{5}));
+    CHECK(!o.contains("k5"));
+    CHECK(!o.extract("k5"));
+    CHECK(!o.extract("missing"));
+    CHECK_EQ(o.size(), size_t(19));
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 20; ++i) {
+        if (i != 5) expected.push_back("k" + std::to_string(i));
+    }
+    CHECK(keys_of(o) == expected);
+    for (int i = 0; i < 20; ++i) {
+        if (i != 5) CHECK(o.at("k" + std::to_string(i)) == jsonn::Value(jsonn::Array{i}));
+    }
+
+    // First and last keys, down to empty
+    CHECK(o.extract("k0") && o.extract("k19"));
+    CHECK_EQ(keys_of(o).front(), std::string("k1"));
+    CHECK_EQ(keys_of(o).back(), std::string("k18"));
+    for (const std::string& k : expected) o.extract(k);
+    CHECK(o.empty());
+}
+
+void test_try_get() {
+    const jsonn::Value values[] = {nullptr, true, int64_t(-1), UINT64_MAX, 2.5, "s", jsonn::Array{}, jsonn::Object{}};
+    for (const jsonn::Value& v : values) {
+        CHECK_EQ(v.try_get_string() != nullptr, v.is_string());
+        CHECK_EQ(v.try_get_array() != nullptr, v.is_array());
+        CHECK_EQ(v.try_get_object() != nullptr, v.is_object());
+        CHECK_EQ(v.try_get_bool().has_value(), v.is_bool());
+        CHECK_EQ(v.try_get_number().has_value(), v.is_number());
+    }
+    // try_get_int only gives integers that fit in int64_t
+    CHECK(values[2].try_get_int() == std::optional<int64_t>(-1));
+    CHECK(!values[3].try_get_int());
+    CHECK(!values[4].try_get_int());
+    CHECK(values[3].try_get_number() == std::optional<double>(static_cast<double>(UINT64_MAX)));
+
+    // Mutable pointers write through
+    jsonn::Value v = jsonn::parse(R"({"list":[1],"name":"a"})");
+    v["list"].try_get_array()->push_back(2);
+    *v["name"].try_get_string() += "b";
+    CHECK(v == jsonn::parse(R"({"list":[1,2],"name":"ab"})"));
+    CHECK(!v["list"].try_get_object());
+    CHECK(!v.try_get_array());
+}
+
+} // namespace
+
+int main() {
+    test_release();
+    test_move_construction();
+    test_push_back_and_insert();
+    test_object_extract();
+    test_try_get();
+    return check_result();
+}